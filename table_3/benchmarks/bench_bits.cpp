@@ -0,0 +1,109 @@
+#include <cstdint>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bits.hpp"
+#include "moves.hpp"
+
+namespace
+{
+
+constexpr std::size_t hands_count {1 << 16};
+constexpr std::size_t rounds {200};
+
+// Random hands of 13 cards in 64-bit layout (16 bits per suit)
+std::vector<uint64_t> make_hands()
+{
+	std::mt19937_64 rnd {12345};
+	std::vector<uint64_t> res;
+	res.reserve(hands_count);
+	for (std::size_t i = 0; i < hands_count; ++i)
+	{
+		uint64_t h {0};
+		for (unsigned placed = 0; placed < 13;)
+		{
+			const auto bit {static_cast<unsigned>(rnd() % 64)};
+			if ((13 > (bit % 16)) && (0 == (h & (static_cast<uint64_t>(1) << bit))))
+			{
+				h |= static_cast<uint64_t>(1) << bit;
+				++placed;
+			}
+		}
+		res.push_back(h);
+	}
+	return res;
+}
+
+template <typename Func>
+void measure(const std::string& name, const std::vector<uint64_t>& hands, Func&& f)
+{
+	uint64_t checksum {0};
+	auto start {std::chrono::steady_clock::now()};
+	for (std::size_t r = 0; r < rounds; ++r)
+	{
+		for (const auto h : hands)
+		{
+			checksum += f(h);
+		}
+	}
+	const auto ns {std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()};
+
+	std::cout << std::setw(28) << std::left << name << std::right << ": "
+			  << std::setw(8) << std::setprecision(3) << std::fixed
+			  << (static_cast<double>(ns) / static_cast<double>(rounds * hands.size())) << " ns/hand"
+			  << " (checksum " << checksum << ")" << std::endl;
+}
+
+// Walk of the 13 ranks of every suit, as first::cards_t::get_available_moves() did before
+uint64_t moves_ranks(uint64_t h)
+{
+	moves_t moves;
+	moves.clear();
+	for (uint8_t s = 0; s < 4; ++s)
+	{
+		const auto cards {static_cast<uint16_t>(h >> (16 * s))};
+		for (const auto& c : card_t::all())
+		{
+			if (0 != (cards & c))
+			{
+				moves.push_back(move_t {c, suit_t {s}, 0});
+			}
+		}
+	}
+	return moves.size() + moves.back().index();
+}
+
+uint64_t moves_intrinsic(uint64_t h)
+{
+	moves_t moves;
+	moves.clear();
+	bits::for_each(h, [&moves](unsigned index) {
+		moves.push_back(move_t::from_index(index));
+	});
+	return moves.size() + moves.back().index();
+}
+
+} // namespace
+
+int main()
+{
+#if defined(TABLE_3_BIT_INTRINSICS) && TABLE_3_BIT_INTRINSICS
+	std::cout << "Bit intrinsics: enabled" << std::endl;
+#else
+	std::cout << "Bit intrinsics: disabled" << std::endl;
+#endif
+
+	const auto hands {make_hands()};
+
+	measure("count (shift loop)", hands, [](uint64_t h) { return bits::portable::count(h); });
+	measure("count (selected)", hands, [](uint64_t h) { return bits::count(h); });
+	measure("moves (13-rank walk)", hands, moves_ranks);
+	measure("moves (lowest bit)", hands, moves_intrinsic);
+
+	return 0;
+}
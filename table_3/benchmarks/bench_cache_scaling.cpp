@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "table_cache_memory.hpp"
+#include "table_cache_sharded.hpp"
+#include "table_processor.hpp"
+#include "table_second.hpp"
+#include "thread_pool.hpp"
+
+namespace
+{
+
+using single_cache_type = table_cache_memory<std::unordered_map, std::mutex>;
+using sharded_cache_type = table_cache_sharded<std::unordered_map>;
+
+// Calculates all tables with the cache shared by threads of the pool, returns milliseconds
+template <typename CacheType>
+double measure(const std::vector<YAML::Node>& tables, std::size_t threads, std::size_t& cache_size)
+{
+	CacheType tc;
+	thread_pool pool {threads};
+	table_processor<second::table_t, CacheType, false> tp {tc, true};
+
+	auto start {std::chrono::steady_clock::now()};
+	for (const auto& n : tables)
+	{
+		tp.process_table_full(second::table_t {n}, pool);
+	}
+	const auto us {std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()};
+
+	cache_size = tc.size();
+	return static_cast<double>(us) / 1000.0;
+}
+
+template <typename CacheType>
+void measure_scaling(const std::string& name, const std::vector<YAML::Node>& tables, std::size_t max_threads)
+{
+	std::vector<std::size_t> threads_counts;
+	for (std::size_t threads = 1; threads < max_threads; threads *= 2)
+	{
+		threads_counts.push_back(threads);
+	}
+	threads_counts.push_back(max_threads);
+
+	double base {0};
+	for (const auto threads : threads_counts)
+	{
+		std::size_t cache_size {0};
+		const double ms {measure<CacheType>(tables, threads, cache_size)};
+		if (1 == threads)
+		{
+			base = ms;
+		}
+
+		std::cout << std::setw(14) << std::left << name << std::right
+				  << " threads " << std::setw(3) << threads << ": "
+				  << std::setw(10) << std::setprecision(1) << std::fixed << ms << " ms; speedup "
+				  << std::setw(5) << std::setprecision(2) << (base / ms) << "; "
+				  << cache_size << " table(s) saved" << std::endl;
+	}
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+	std::size_t max_threads {std::max<std::size_t>(std::thread::hardware_concurrency(), 1)};
+	int arg {1};
+	if (((arg + 1) < argc) && ("-j" == std::string {argv[arg]}))
+	{
+		max_threads = std::stoul(argv[arg + 1]);
+		arg += 2;
+	}
+
+	if (arg >= argc)
+	{
+		std::cout << "Usage: " << argv[0] << " [-j max_threads] <tables.yml>..." << std::endl;
+		return 1;
+	}
+
+	for (; arg < argc; ++arg)
+	{
+		std::vector<YAML::Node> tables;
+		for (const auto& n : YAML::LoadFile(argv[arg]))
+		{
+			tables.push_back(n);
+		}
+
+		std::cout << argv[arg] << " (" << tables.size() << " table(s)):" << std::endl;
+		measure_scaling<single_cache_type>("single mutex", tables, max_threads);
+		measure_scaling<sharded_cache_type>("sharded", tables, max_threads);
+	}
+
+	return 0;
+}
@@ -0,0 +1,201 @@
+#include <cstdint>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "table_hash.hpp"
+#include "table_key.hpp"
+#include "table_second.hpp"
+
+namespace
+{
+
+constexpr std::size_t playouts {4096};
+constexpr std::size_t bucket_bits {16};
+constexpr std::size_t rounds {100};
+
+// Byte-wise Fowler-Noll-Vo hash used by table_hash before (reference)
+uint64_t hash_fnv(const table_hash& h)
+{
+	std::size_t result {2166136261};
+	for (std::size_t i = 0; i < table_hash::size(); ++i)
+	{
+		result = (result * 16777619) ^ h.data()[i];
+	}
+	return result;
+}
+
+// Zobrist hash of the key bytes: one random word per (byte position, bit)
+class zobrist
+{
+public:
+	zobrist()
+	{
+		std::mt19937_64 rnd {12345};
+		for (auto& w : keys_)
+		{
+			w = rnd();
+		}
+	}
+
+	inline uint64_t operator()(const table_hash& h) const noexcept
+	{
+		uint64_t res {0};
+		for (std::size_t i = 0; i < table_hash::size(); ++i)
+		{
+			for (unsigned bit = 0; bit < 8; ++bit)
+			{
+				if (0 != (h.data()[i] & (1u << bit)))
+				{
+					res ^= keys_[i * 8 + bit];
+				}
+			}
+		}
+		return res;
+	}
+
+	// Incremental update of a raw (not canonical) key: one card of one hand
+	inline uint64_t card(std::size_t side, std::size_t index) const noexcept
+	{
+		return keys_[side * 64 + index];
+	}
+
+private:
+	uint64_t keys_[table_hash::size() * 8];
+};
+
+struct position
+{
+	table_key key_;
+	second::table_t table_;
+};
+
+// Positions met at the trick starts of random playouts of the table
+void collect_positions(const second::table_t& start, std::mt19937_64& rnd, std::vector<position>& res)
+{
+	for (std::size_t p = 0; p < playouts; ++p)
+	{
+		auto t {start};
+		moves_t moves;
+		while (!t.empty())
+		{
+			if (t.is_first_move() && (3 <= t.max_tricks()))
+			{
+				position pos {table_key {}, t};
+				t.get_key(pos.key_);
+				res.push_back(pos);
+			}
+			t.get_available_moves(moves);
+			t.make_move(moves[rnd() % moves.size()]);
+		}
+	}
+}
+
+template <typename Func>
+void measure_quality(const std::string& name, const std::vector<table_hash>& keys, Func&& f)
+{
+	std::unordered_set<uint64_t> values;
+	std::vector<std::size_t> buckets(static_cast<std::size_t>(1) << bucket_bits);
+	for (const auto& k : keys)
+	{
+		const uint64_t h {f(k)};
+		values.insert(h);
+		++buckets[h & (buckets.size() - 1)];
+	}
+
+	// Uniform hash leaves every bucket with keys/buckets entries on average
+	const double expected {static_cast<double>(keys.size()) / static_cast<double>(buckets.size())};
+	double chi2 {0};
+	for (const auto b : buckets)
+	{
+		chi2 += (static_cast<double>(b) - expected) * (static_cast<double>(b) - expected) / expected;
+	}
+
+	std::cout << std::setw(24) << std::left << name << std::right << ": "
+			  << std::setw(6) << (keys.size() - values.size()) << " 64-bit collision(s); max bucket "
+			  << std::setw(4) << *std::max_element(buckets.begin(), buckets.end()) << " (expected "
+			  << std::setprecision(2) << std::fixed << expected << "); chi2/buckets "
+			  << std::setprecision(3) << (chi2 / static_cast<double>(buckets.size())) << std::endl;
+}
+
+template <typename Items, typename Func>
+void measure_cost(const std::string& name, const Items& items, Func&& f)
+{
+	uint64_t checksum {0};
+	auto start {std::chrono::steady_clock::now()};
+	for (std::size_t r = 0; r < rounds; ++r)
+	{
+		for (const auto& item : items)
+		{
+			checksum += f(item);
+		}
+	}
+	const auto ns {std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()};
+
+	std::cout << std::setw(24) << std::left << name << std::right << ": "
+			  << std::setw(8) << std::setprecision(2) << std::fixed
+			  << (static_cast<double>(ns) / static_cast<double>(rounds * items.size())) << " ns/probe"
+			  << " (checksum " << checksum << ")" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+	if (2 > argc)
+	{
+		std::cout << "Usage: " << argv[0] << " <tables.yml>..." << std::endl;
+		return 1;
+	}
+
+	std::mt19937_64 rnd {12345};
+	std::vector<position> positions;
+	for (int arg = 1; arg < argc; ++arg)
+	{
+		for (const auto& n : YAML::LoadFile(argv[arg]))
+		{
+			collect_positions(second::table_t {n}, rnd, positions);
+		}
+	}
+
+	// Quality is measured on distinct canonical keys only
+	std::vector<table_hash> keys;
+	for (const auto& p : positions)
+	{
+		keys.push_back(p.key_.hash());
+	}
+	std::sort(keys.begin(), keys.end());
+	keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+	std::cout << positions.size() << " position(s), " << keys.size() << " distinct key(s), "
+			  << (static_cast<std::size_t>(1) << bucket_bits) << " bucket(s):" << std::endl;
+
+	const zobrist z;
+	measure_quality("FNV-1 (bytes)", keys, hash_fnv);
+	measure_quality("table_hash::hash()", keys, [](const table_hash& h) { return static_cast<uint64_t>(h.hash()); });
+	measure_quality("Zobrist (bits)", keys, z);
+
+	std::cout << "Probe cost:" << std::endl;
+	measure_cost("FNV-1 (bytes)", keys, hash_fnv);
+	measure_cost("table_hash::hash()", keys, [](const table_hash& h) { return static_cast<uint64_t>(h.hash()); });
+	measure_cost("Zobrist (bits)", keys, z);
+	measure_cost("Zobrist (one card)", positions, [&z](const position& p) {
+		const auto side {p.table_.current_player()};
+		return z.card(static_cast<std::size_t>(side), bits::lowest(p.table_.hand(side)));
+	});
+	measure_cost("get_key() + hash()", positions, [](const position& p) {
+		table_key key;
+		p.table_.get_key(key);
+		return static_cast<uint64_t>(key.hash().hash());
+	});
+
+	return 0;
+}
@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "table_cache_bounds.hpp"
+#include "table_processor_ab.hpp"
+#include "table_second.hpp"
+#include "thread_pool.hpp"
+
+namespace
+{
+
+using cache_type = table_cache_bounds<std::mutex>;
+using processor_type = table_processor_ab<second::table_t, cache_type>;
+
+constexpr std::size_t cache_budget {64 * 1024 * 1024};
+
+enum class split_t
+{
+	serial,
+	root,
+	ybwc,
+};
+
+struct measurement
+{
+	double ms_;
+	uint64_t iterations_;
+};
+
+// Calculates all tables (strains one by one, every calculation split as requested) with a new cache
+measurement measure(const std::vector<YAML::Node>& tables, split_t split, std::size_t threads, std::size_t plies)
+{
+	cache_type tc {cache_budget};
+	std::unique_ptr<thread_pool> pool;
+	processor_type tp {tc, move_ordering_t::history, true};
+	if (split_t::serial != split)
+	{
+		pool = std::make_unique<thread_pool>(threads);
+		if (split_t::root == split)
+		{
+			tp.set_root_split(pool.get(), 1);
+		}
+		else
+		{
+			tp.set_parallel_plies(pool.get(), plies);
+		}
+	}
+
+	uint64_t iterations {0};
+	auto start {std::chrono::steady_clock::now()};
+	for (const auto& n : tables)
+	{
+		tc.new_generation();
+		tp.process_table_full(second::table_t {n});
+		iterations += tp.total_iterations();
+	}
+	const auto us {std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()};
+
+	return measurement {static_cast<double>(us) / 1000.0, iterations};
+}
+
+void out_measurement(const std::string& name, std::size_t threads, const measurement& m, const measurement& serial)
+{
+	std::cout << std::setw(12) << std::left << name << std::right
+			  << " threads " << std::setw(3) << threads << ": "
+			  << std::setw(10) << std::setprecision(1) << std::fixed << m.ms_ << " ms; speedup "
+			  << std::setw(5) << std::setprecision(2) << (serial.ms_ / m.ms_) << "; "
+			  << std::setw(12) << m.iterations_ << " node(s), overhead "
+			  << std::setw(5) << std::setprecision(2)
+			  << (static_cast<double>(m.iterations_) / static_cast<double>(serial.iterations_)) << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+	std::size_t max_threads {std::max<std::size_t>(std::thread::hardware_concurrency(), 1)};
+	std::size_t plies {4};
+	int arg {1};
+	for (; ((arg + 1) < argc) && ('-' == argv[arg][0]); arg += 2)
+	{
+		const std::string option {argv[arg]};
+		if ("-j" == option)
+		{
+			max_threads = std::stoul(argv[arg + 1]);
+		}
+		else if ("-y" == option)
+		{
+			plies = std::stoul(argv[arg + 1]);
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	if (arg >= argc)
+	{
+		std::cout << "Usage: " << argv[0] << " [-j max_threads] [-y parallel_plies] <tables.yml>..." << std::endl;
+		return 1;
+	}
+
+	std::vector<std::size_t> threads_counts;
+	for (std::size_t threads = 1; threads < max_threads; threads *= 2)
+	{
+		threads_counts.push_back(threads);
+	}
+	threads_counts.push_back(max_threads);
+
+	// Speedups above 1 need spare cores: with less hardware threads they come from scheduling only
+	std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+
+	for (; arg < argc; ++arg)
+	{
+		std::vector<YAML::Node> tables;
+		for (const auto& n : YAML::LoadFile(argv[arg]))
+		{
+			tables.push_back(n);
+		}
+
+		std::cout << argv[arg] << " (" << tables.size() << " table(s)):" << std::endl;
+
+		const auto serial {measure(tables, split_t::serial, 1, 0)};
+		out_measurement("serial", 1, serial, serial);
+		for (const auto threads : threads_counts)
+		{
+			out_measurement("root split", threads, measure(tables, split_t::root, threads, 0), serial);
+		}
+		for (const auto threads : threads_counts)
+		{
+			out_measurement("ybwc", threads, measure(tables, split_t::ybwc, threads, plies), serial);
+		}
+	}
+
+	return 0;
+}
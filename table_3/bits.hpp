@@ -0,0 +1,118 @@
+#ifndef BITS_HPP
+#define BITS_HPP
+
+#include <cstdint>
+
+#if defined(TABLE_3_BIT_INTRINSICS) && TABLE_3_BIT_INTRINSICS && defined(__has_include)
+#if __has_include(<bit>)
+#include <bit>
+#endif
+#endif
+
+namespace bits
+{
+
+// Plain implementations, used when intrinsics are disabled or not available.
+namespace portable
+{
+
+inline constexpr unsigned count(uint64_t v) noexcept
+{
+	unsigned res {0};
+	for (; 0 != v; v >>= 1)
+	{
+		res += static_cast<unsigned>(v & 1);
+	}
+	return res;
+}
+
+// Index of the lowest set bit; v must not be zero.
+inline constexpr unsigned lowest(uint64_t v) noexcept
+{
+	unsigned res {0};
+	for (; 0 == (v & 1); v >>= 1)
+	{
+		++res;
+	}
+	return res;
+}
+
+// Index of the highest set bit; v must not be zero.
+inline constexpr unsigned highest(uint64_t v) noexcept
+{
+	unsigned res {0};
+	for (v >>= 1; 0 != v; v >>= 1)
+	{
+		++res;
+	}
+	return res;
+}
+
+} // namespace portable
+
+#if defined(TABLE_3_BIT_INTRINSICS) && TABLE_3_BIT_INTRINSICS && defined(__cpp_lib_bitops)
+
+inline constexpr unsigned count(uint64_t v) noexcept
+{
+	return static_cast<unsigned>(std::popcount(v));
+}
+
+inline constexpr unsigned lowest(uint64_t v) noexcept
+{
+	return static_cast<unsigned>(std::countr_zero(v));
+}
+
+inline constexpr unsigned highest(uint64_t v) noexcept
+{
+	return static_cast<unsigned>(std::bit_width(v) - 1);
+}
+
+#elif defined(TABLE_3_BIT_INTRINSICS) && TABLE_3_BIT_INTRINSICS && (defined(__GNUC__) || defined(__clang__))
+
+inline constexpr unsigned count(uint64_t v) noexcept
+{
+	return static_cast<unsigned>(__builtin_popcountll(v));
+}
+
+inline constexpr unsigned lowest(uint64_t v) noexcept
+{
+	return static_cast<unsigned>(__builtin_ctzll(v));
+}
+
+inline constexpr unsigned highest(uint64_t v) noexcept
+{
+	return static_cast<unsigned>(63 - __builtin_clzll(v));
+}
+
+#else
+
+inline constexpr unsigned count(uint64_t v) noexcept
+{
+	return portable::count(v);
+}
+
+inline constexpr unsigned lowest(uint64_t v) noexcept
+{
+	return portable::lowest(v);
+}
+
+inline constexpr unsigned highest(uint64_t v) noexcept
+{
+	return portable::highest(v);
+}
+
+#endif
+
+// Calls f(index) for every set bit from the lowest one.
+template <typename Func>
+inline void for_each(uint64_t v, Func&& f)
+{
+	for (; 0 != v; v &= (v - 1))
+	{
+		f(lowest(v));
+	}
+}
+
+} // namespace bits
+
+#endif // BITS_HPP
@@ -0,0 +1,49 @@
+#ifndef DEAL_HPP
+#define DEAL_HPP
+
+#include <cstdint>
+
+#include <yaml-cpp/yaml.h>
+
+#include "enums.hpp"
+#include "table_first.h"
+
+/**
+ *****************************************************************************
+ * @brief The deal_t struct - deal read from the deal file: the table and the
+ * results stored in the file (tricks of NS for every declarer and trump)
+ * to compare with.
+ */
+struct deal_t
+{
+	first::table_t table_;
+	bool has_results_ {false};
+	uint8_t results_[4][5] {};
+
+	inline deal_t() = default;
+
+	// Results are taken only if all of them are present and valid
+	inline explicit deal_t(const YAML::Node& n)
+		: table_ {n}
+	{
+		try
+		{
+			const auto rc {n["Result"]};
+			for (const auto& side : side_t::all())
+			{
+				const auto src {rc[side.to_string_short()]};
+				for (const auto& trump : suit_t::all())
+				{
+					results_[side][trump] = src[static_cast<uint8_t>(trump)].as<uint8_t>();
+				}
+			}
+			has_results_ = true;
+		}
+		catch (const YAML::Exception&)
+		{
+			has_results_ = false;
+		}
+	}
+};
+
+#endif // DEAL_HPP
@@ -0,0 +1,229 @@
+#include "deal_binary.hpp"
+
+#include <cstring>
+
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace deal_binary
+{
+
+bool is_binary_file(const std::string& path)
+{
+	std::ifstream stream {path, std::ios::binary};
+	char buffer[sizeof(magic)] {};
+	return stream.read(buffer, sizeof(buffer)) && (0 == std::memcmp(buffer, magic, sizeof(magic)));
+}
+
+writer::writer(const std::string& path)
+	: stream_ {path, std::ios::binary | std::ios::trunc}
+	, path_ {path}
+{
+	if (!stream_)
+	{
+		throw std::runtime_error {"can not create deal file \"" + path + "\""};
+	}
+
+	// Header is written again with the number of deals by close()
+	header h {};
+	std::memcpy(h.magic_, magic, sizeof(magic));
+	h.version_ = version;
+	h.record_size_ = sizeof(record);
+	h.count_ = incomplete_count;
+	stream_.write(reinterpret_cast<const char*>(&h), sizeof(h));
+}
+
+writer::~writer()
+{
+	// Not closed by close(): the header keeps incomplete_count
+	if (stream_.is_open())
+	{
+		stream_.close();
+	}
+}
+
+void writer::write(const deal_t& deal)
+{
+	const auto& t {deal.table_};
+	if (sizeof(record::moves_) < t.moves().size())
+	{
+		throw std::runtime_error {"deal " + std::to_string(count_ + 1) + " has " + std::to_string(t.moves().size())
+								  + " moves made, only moves of the current trick can be written"};
+	}
+
+	record r {};
+	for (const auto& side : side_t::all())
+	{
+		for (uint8_t s = 0; s < 4; ++s)
+		{
+			r.hands_[side] |= static_cast<uint64_t>(t.suit_cards(side, suit_t {s})) << (16 * s);
+		}
+	}
+	r.trump_ = static_cast<uint8_t>(t.trump());
+	r.turn_starter_ = static_cast<uint8_t>(t.turn_starter());
+	r.moves_count_ = static_cast<uint8_t>(t.moves().size());
+	for (std::size_t i = 0; i < t.moves().size(); ++i)
+	{
+		r.moves_[i] = static_cast<uint8_t>(t.moves()[i].index());
+	}
+	r.has_results_ = deal.has_results_ ? 1 : 0;
+	std::memcpy(r.results_, deal.results_, sizeof(r.results_));
+
+	stream_.write(reinterpret_cast<const char*>(&r), sizeof(r));
+	if (!stream_)
+	{
+		throw std::runtime_error {"can not write deal file \"" + path_ + "\""};
+	}
+	++count_;
+}
+
+void writer::close()
+{
+	if (!stream_.is_open())
+	{
+		return;
+	}
+
+	header h {};
+	std::memcpy(h.magic_, magic, sizeof(magic));
+	h.version_ = version;
+	h.record_size_ = sizeof(record);
+	h.count_ = count_;
+
+	stream_.seekp(0);
+	stream_.write(reinterpret_cast<const char*>(&h), sizeof(h));
+	stream_.close();
+	if (!stream_)
+	{
+		throw std::runtime_error {"can not write deal file \"" + path_ + "\""};
+	}
+}
+
+file::file(const std::string& path)
+	: path_ {path}
+{
+	const int fd {::open(path.c_str(), O_RDONLY)};
+	if (0 > fd)
+	{
+		throw std::system_error {errno, std::generic_category(), "can not open deal file \"" + path + "\""};
+	}
+
+	struct stat st {};
+	if (0 != ::fstat(fd, &st))
+	{
+		const int error {errno};
+		::close(fd);
+		throw std::system_error {error, std::generic_category(), "can not open deal file \"" + path + "\""};
+	}
+	length_ = static_cast<std::size_t>(st.st_size);
+
+	void* data {(sizeof(header) <= length_) ? ::mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED};
+	::close(fd);
+	if (MAP_FAILED == data)
+	{
+		throw std::runtime_error {"can not map deal file \"" + path + "\""};
+	}
+	data_ = static_cast<const unsigned char*>(data);
+
+	// Records are read one after another
+	::madvise(data, length_, MADV_SEQUENTIAL);
+
+	header h {};
+	std::memcpy(&h, data_, sizeof(h));
+	if (incomplete_count == h.count_)
+	{
+		::munmap(const_cast<unsigned char*>(data_), length_);
+		data_ = nullptr;
+		throw std::runtime_error {"\"" + path + "\" is not a completely written binary deal file"};
+	}
+
+	const bool valid {(0 == std::memcmp(h.magic_, magic, sizeof(magic))) && (version == h.version_)
+					  && (sizeof(record) == h.record_size_)
+					  && (length_ == (sizeof(header) + h.count_ * sizeof(record)))};
+	if (!valid)
+	{
+		::munmap(const_cast<unsigned char*>(data_), length_);
+		data_ = nullptr;
+		throw std::runtime_error {"\"" + path + "\" is not a valid binary deal file (version "
+								  + std::to_string(version) + ")"};
+	}
+	count_ = static_cast<std::size_t>(h.count_);
+}
+
+file::~file()
+{
+	if (nullptr != data_)
+	{
+		::munmap(const_cast<unsigned char*>(data_), length_);
+	}
+}
+
+void file::read(std::size_t index, deal_t& deal) const
+{
+	record r;
+	std::memcpy(&r, data_ + sizeof(header) + index * sizeof(record), sizeof(r));
+
+	const auto invalid {[&](const std::string& what) {
+		return std::runtime_error {"record #" + std::to_string(index) + " of deal file \"" + path_ + "\" has invalid "
+								   + what};
+	}};
+
+	// Ranks 13..15 of every suit are not cards
+	constexpr uint64_t cards_mask {0x1FFF1FFF1FFF1FFFull};
+	for (const auto hand : r.hands_)
+	{
+		if (0 != (hand & ~cards_mask))
+		{
+			throw invalid("hands");
+		}
+	}
+	if (4 < r.trump_)
+	{
+		throw invalid("trump " + std::to_string(r.trump_));
+	}
+	if (3 < r.turn_starter_)
+	{
+		throw invalid("turn starter " + std::to_string(r.turn_starter_));
+	}
+	if (3 < r.moves_count_)
+	{
+		throw invalid("number of moves " + std::to_string(r.moves_count_));
+	}
+
+	moves_t moves;
+	moves.clear();
+	for (std::size_t i = 0; i < r.moves_count_; ++i)
+	{
+		if ((64 <= r.moves_[i]) || (13 <= (r.moves_[i] & 0x0F)))
+		{
+			throw invalid("move " + std::to_string(r.moves_[i]));
+		}
+		moves.push_back(move_t::from_index(r.moves_[i]));
+	}
+
+	if (0 != r.has_results_)
+	{
+		for (const auto& row : r.results_)
+		{
+			for (const auto tricks : row)
+			{
+				if (13 < tricks)
+				{
+					throw invalid("result " + std::to_string(tricks));
+				}
+			}
+		}
+	}
+
+	deal.table_ = first::table_t {r.hands_, suit_t {static_cast<suit_t::suits>(r.trump_)},
+								  side_t {static_cast<side_t::sides>(r.turn_starter_)}, moves};
+	deal.has_results_ = (0 != r.has_results_);
+	std::memcpy(deal.results_, r.results_, sizeof(deal.results_));
+}
+
+} // namespace deal_binary
@@ -0,0 +1,125 @@
+#ifndef DEAL_BINARY_HPP
+#define DEAL_BINARY_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <fstream>
+#include <string>
+
+#include "deal.hpp"
+
+/**
+ *****************************************************************************
+ * Binary deal files: header followed by fixed size records, one per deal.
+ * Values are written in host byte order (little-endian on all supported
+ * platforms); files of other byte order fail the version check.
+ */
+namespace deal_binary
+{
+
+inline constexpr char magic[8] {'T', '3', 'D', 'E', 'A', 'L', 'S', '\0'};
+inline constexpr uint32_t version {1};
+
+// Number of deals in the header of the file being written (or not finished by writer::close())
+inline constexpr uint64_t incomplete_count {~uint64_t {0}};
+
+struct header
+{
+	char magic_[8];
+	uint32_t version_;
+	uint32_t record_size_;
+	uint64_t count_;
+};
+
+static_assert(24 == sizeof(header));
+
+struct record
+{
+	uint64_t hands_[4];     // N, E, S, W: 16 bits (card_t bits) per suit, clubs are the lowest ones
+	uint8_t trump_;         // suit_t, 4 for no trump
+	uint8_t turn_starter_;  // side_t
+	uint8_t moves_count_;   // moves of the current trick made already
+	uint8_t has_results_;
+	uint8_t moves_[3];      // move_t::index()
+	uint8_t reserved_;
+	uint8_t results_[4][5]; // NS tricks for [declarer][trump], see deal_t
+	uint8_t padding_[4];
+};
+
+static_assert(64 == sizeof(record));
+
+// Returns true if the file starts with the header of a binary deal file.
+bool is_binary_file(const std::string& path);
+
+/**
+ *****************************************************************************
+ * @brief The writer class - writes deals into a new binary deal file; the
+ * number of deals is written into the header by close(). Until then the
+ * header has incomplete_count, so the file not closed by close() (e.g. left
+ * by an exception) is rejected by readers.
+ */
+class writer
+{
+public:
+	// Throws std::runtime_error if the file can not be created.
+	explicit writer(const std::string& path);
+	~writer();
+
+	writer(const writer&) = delete;
+	writer(writer&&) = delete;
+	writer& operator=(const writer&) = delete;
+	writer& operator=(writer&&) = delete;
+
+public:
+	// Throws std::runtime_error if the deal has more than 3 moves made or data can not be written.
+	void write(const deal_t& deal);
+	void close();
+
+	inline uint64_t count() const noexcept
+	{
+		return count_;
+	}
+
+private:
+	std::ofstream stream_;
+	std::string path_;
+	uint64_t count_ {0};
+};
+
+/**
+ *****************************************************************************
+ * @brief The file class - binary deal file mapped into memory; deals are
+ * constructed from records without any parsing.
+ */
+class file
+{
+public:
+	// Throws std::runtime_error if the file can not be mapped or is not a valid binary deal file.
+	explicit file(const std::string& path);
+	~file();
+
+	file(const file&) = delete;
+	file(file&&) = delete;
+	file& operator=(const file&) = delete;
+	file& operator=(file&&) = delete;
+
+public:
+	inline std::size_t size() const noexcept
+	{
+		return count_;
+	}
+
+	// Throws std::runtime_error if the record has values out of their ranges.
+	void read(std::size_t index, deal_t& deal) const;
+
+private:
+	std::string path_;
+	const unsigned char* data_ {nullptr};
+	std::size_t length_ {0};
+	std::size_t count_ {0};
+};
+
+} // namespace deal_binary
+
+#endif // DEAL_BINARY_HPP
@@ -0,0 +1,252 @@
+#include "deal_import.hpp"
+
+namespace
+{
+
+constexpr uint64_t all_cards {0x1FFF1FFF1FFF1FFFull};
+
+// Shift of the suit in the hand mask
+inline int suit_shift(char c) noexcept
+{
+	switch (c)
+	{
+	case 'C':
+	case 'c':
+		return 0;
+	case 'D':
+	case 'd':
+		return 16;
+	case 'H':
+	case 'h':
+		return 32;
+	case 'S':
+	case 's':
+		return 48;
+	default:
+		return -1;
+	}
+}
+
+// Reads the rank at p ("T" or "10" for ten) and returns its card_t bit; 0 for other characters.
+inline uint64_t next_rank(const char*& p, const char* end) noexcept
+{
+	switch (*p)
+	{
+	case 'A':
+	case 'a':
+		++p;
+		return card_t::Ace;
+	case 'K':
+	case 'k':
+		++p;
+		return card_t::King;
+	case 'Q':
+	case 'q':
+		++p;
+		return card_t::Queen;
+	case 'J':
+	case 'j':
+		++p;
+		return card_t::Jack;
+	case 'T':
+	case 't':
+		++p;
+		return card_t::C_10;
+	case '1':
+		if (((p + 1) < end) && ('0' == p[1]))
+		{
+			p += 2;
+			return card_t::C_10;
+		}
+		return 0;
+	default:
+		if (('2' <= *p) && ('9' >= *p))
+		{
+			return static_cast<uint64_t>(1) << (*(p++) - '2');
+		}
+		return 0;
+	}
+}
+
+// The only unknown hand (if any) gets the cards missing in the other ones
+inline void fill_unknown(uint64_t (&hands)[4], int unknown) noexcept
+{
+	if (0 <= unknown)
+	{
+		hands[unknown] = all_cards & ~(hands[0] | hands[1] | hands[2] | hands[3]);
+	}
+}
+
+} // namespace
+
+namespace deal_import
+{
+
+bool parse_side(char c, side_t& side) noexcept
+{
+	switch (c)
+	{
+	case 'N':
+	case 'n':
+		side = side_t::North;
+		return true;
+	case 'E':
+	case 'e':
+		side = side_t::East;
+		return true;
+	case 'S':
+	case 's':
+		side = side_t::South;
+		return true;
+	case 'W':
+	case 'w':
+		side = side_t::West;
+		return true;
+	default:
+		return false;
+	}
+}
+
+bool parse_strain(char c, suit_t& strain) noexcept
+{
+	const int shift {suit_shift(c)};
+	if (0 <= shift)
+	{
+		strain = suit_t {static_cast<suit_t::suits>(shift / 16)};
+		return true;
+	}
+	if (('N' == c) || ('n' == c))
+	{
+		strain = suit_t::NoTrump;
+		return true;
+	}
+	return false;
+}
+
+bool parse_pbn_deal(const char* begin, const char* end, uint64_t (&hands)[4], side_t& first) noexcept
+{
+	const char* p {begin};
+	while ((p < end) && (' ' == *p))
+	{
+		++p;
+	}
+	if (((p + 2) > end) || (':' != p[1]))
+	{
+		return false;
+	}
+
+	if (!parse_side(*p, first))
+	{
+		return false;
+	}
+	p += 2;
+
+	int unknown {-1};
+	for (std::size_t i = 0; i < 4; ++i)
+	{
+		const auto side {first + i};
+		uint64_t& hand {hands[side]};
+		hand = 0;
+
+		while ((p < end) && (' ' == *p))
+		{
+			++p;
+		}
+		if ((p < end) && ('-' == *p))
+		{
+			if (0 <= unknown)
+			{
+				return false;
+			}
+			unknown = static_cast<int>(static_cast<std::size_t>(side));
+			++p;
+			continue;
+		}
+
+		// Spades first
+		for (int shift = 48; shift >= 0; shift -= 16)
+		{
+			while (p < end)
+			{
+				const uint64_t rank {next_rank(p, end)};
+				if (0 == rank)
+				{
+					break;
+				}
+				hand |= rank << shift;
+			}
+			if (0 != shift)
+			{
+				if ((p >= end) || ('.' != *p))
+				{
+					return false;
+				}
+				++p;
+			}
+		}
+		if ((p < end) && (' ' != *p))
+		{
+			return false;
+		}
+	}
+
+	fill_unknown(hands, unknown);
+	return true;
+}
+
+bool parse_lin_deal(const char* begin, const char* end, uint64_t (&hands)[4], side_t& dealer) noexcept
+{
+	static constexpr side_t::sides order[4] {side_t::South, side_t::West, side_t::North, side_t::East};
+
+	const char* p {begin};
+	dealer = side_t::South;
+	if ((p < end) && ('1' <= *p) && ('4' >= *p))
+	{
+		dealer = order[*(p++) - '1'];
+	}
+
+	for (auto& h : hands)
+	{
+		h = 0;
+	}
+
+	int unknown {-1};
+	for (std::size_t i = 0; i < 4; ++i)
+	{
+		const auto side {order[i]};
+		uint64_t& hand {hands[side]};
+
+		int shift {-1};
+		while ((p < end) && (',' != *p))
+		{
+			const int s {suit_shift(*p)};
+			if (0 <= s)
+			{
+				shift = s;
+				++p;
+				continue;
+			}
+
+			const uint64_t rank {next_rank(p, end)};
+			if ((0 == rank) || (0 > shift))
+			{
+				return false;
+			}
+			hand |= rank << shift;
+		}
+
+		if ((3 == i) && (0 == hand))
+		{
+			unknown = static_cast<int>(side);
+		}
+		if (p < end)
+		{
+			++p;
+		}
+	}
+
+	fill_unknown(hands, unknown);
+	return true;
+}
+
+} // namespace deal_import
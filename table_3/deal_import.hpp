@@ -0,0 +1,36 @@
+#ifndef DEAL_IMPORT_HPP
+#define DEAL_IMPORT_HPP
+
+#include <cstdint>
+
+#include "enums.hpp"
+
+/**
+ *****************************************************************************
+ * Parsers of deals in the formats of tournament software (PBN and BBO LIN).
+ * Hands are returned as 64-bit masks of N, E, S, W in the layout of
+ * first::hand_t (16 bits per suit, clubs are the lowest ones). Parsers do
+ * not allocate and do not throw: they are called for every deal of a batch.
+ */
+namespace deal_import
+{
+
+// Side by its letter (N, E, S, W); returns false for other characters.
+bool parse_side(char c, side_t& side) noexcept;
+
+// Strain by its letter (C, D, H, S, N for no trump); returns false for other characters.
+bool parse_strain(char c, suit_t& strain) noexcept;
+
+// Value of the PBN Deal tag ("N:AKQ.JT9.876.5432 ..."): side of the first hand, then hands
+// clockwise, every hand is spades, hearts, diamonds and clubs separated by dots. One hand may be
+// "-" (unknown), it gets all cards missing in the other ones. Returns false for malformed values.
+bool parse_pbn_deal(const char* begin, const char* end, uint64_t (&hands)[4], side_t& first) noexcept;
+
+// Value of the LIN md field ("3SAK2HQ95D...C...,S...,S...,"): dealer (1 - South, 2 - West,
+// 3 - North, 4 - East), then hands of South, West, North and East, every suit is its letter
+// followed by ranks. Empty last hand gets all missing cards. Returns false for malformed values.
+bool parse_lin_deal(const char* begin, const char* end, uint64_t (&hands)[4], side_t& dealer) noexcept;
+
+} // namespace deal_import
+
+#endif // DEAL_IMPORT_HPP
@@ -0,0 +1,474 @@
+#include "deal_reader.hpp"
+
+#include <cctype>
+
+#include <stdexcept>
+#include <string_view>
+
+#include "deal_import.hpp"
+
+namespace
+{
+
+// Name and value of the PBN tag line ([Name "Value"]) starting at pos
+void split_tag(const std::string& line, std::size_t pos, std::string_view& name, std::string_view& value) noexcept
+{
+	const std::string_view s {line};
+	const auto name_end {s.find_first_of(" \t\"]", pos + 1)};
+	name = s.substr(pos + 1, (std::string_view::npos == name_end) ? std::string_view::npos : (name_end - pos - 1));
+
+	const auto value_begin {s.find('"', pos)};
+	const auto value_end {s.rfind('"')};
+	value = ((std::string_view::npos != value_begin) && (value_begin < value_end))
+				? s.substr(value_begin + 1, value_end - value_begin - 1)
+				: std::string_view {};
+}
+
+// Line of the OptimumResultTable tag ("N NT 6"): tricks of the declarer in the strain; returns the bit
+// of the entry (see deal_reader::read_pbn) or 0 for malformed lines.
+uint32_t parse_result(const std::string& line, uint8_t (&tricks)[4][5]) noexcept
+{
+	std::string_view fields[3];
+	std::size_t pos {0};
+	for (auto& f : fields)
+	{
+		const auto begin {line.find_first_not_of(" \t\r", pos)};
+		if (std::string::npos == begin)
+		{
+			return 0;
+		}
+		pos = line.find_first_of(" \t\r", begin);
+		f = std::string_view {line}.substr(begin, (std::string::npos == pos) ? std::string::npos : (pos - begin));
+	}
+
+	side_t declarer;
+	suit_t strain;
+	if (!deal_import::parse_side(fields[0][0], declarer) || !deal_import::parse_strain(fields[1][0], strain)
+		|| (!std::isdigit(static_cast<unsigned char>(fields[2][0]))))
+	{
+		return 0;
+	}
+
+	uint8_t value {0};
+	for (const char c : fields[2])
+	{
+		if (!std::isdigit(static_cast<unsigned char>(c)))
+		{
+			break;
+		}
+		value = static_cast<uint8_t>(value * 10 + (c - '0'));
+	}
+	tricks[declarer][strain] = value;
+	return static_cast<uint32_t>(1) << (declarer * 5 + strain);
+}
+
+} // namespace
+
+deal_reader::deal_reader(const std::string& path)
+	: stream_ {path}
+	, path_ {path}
+{
+	if (!stream_)
+	{
+		throw std::runtime_error {"can not open deal file \"" + path + "\""};
+	}
+
+	if (deal_binary::is_binary_file(path))
+	{
+		stream_.close();
+		format_ = format_t::binary;
+		binary_ = std::make_unique<deal_binary::file>(path);
+		return;
+	}
+
+	// Comments, blank lines and document markers before the first item are skipped
+	while ((has_line_ = read_line()))
+	{
+		if ((1 == line_number_) && (0 == line_.compare(0, 3, "\xEF\xBB\xBF")))
+		{
+			line_.erase(0, 3);
+		}
+		if (!is_ignored(line_))
+		{
+			break;
+		}
+	}
+
+	if (!has_line_ || is_item_start(line_))
+	{
+		return;
+	}
+
+	if (is_pbn_tag(line_))
+	{
+		format_ = format_t::pbn;
+	}
+	else if (is_lin_field(line_))
+	{
+		format_ = format_t::lin;
+	}
+	else
+	{
+		stream_.close();
+		has_line_ = false;
+		format_ = format_t::document;
+		document_ = YAML::LoadFile(path);
+		document_it_ = document_.begin();
+	}
+}
+
+bool deal_reader::next(deal_t& deal)
+{
+	switch (format_)
+	{
+	case format_t::binary:
+		if (binary_->size() <= count_)
+		{
+			return false;
+		}
+		binary_->read(count_++, deal);
+		return true;
+	case format_t::pbn:
+		return read_pbn(&deal);
+	case format_t::lin:
+		return read_lin(&deal);
+	default:
+		break;
+	}
+
+	YAML::Node n;
+	if (!next(n))
+	{
+		return false;
+	}
+	deal = deal_t {n};
+	return true;
+}
+
+bool deal_reader::next(YAML::Node& deal)
+{
+	if (format_t::document == format_)
+	{
+		if (document_.end() == document_it_)
+		{
+			return false;
+		}
+		deal.reset(*document_it_++);
+		++count_;
+		return true;
+	}
+
+	if (!read_item())
+	{
+		return false;
+	}
+
+	try
+	{
+		deal.reset(YAML::Load(item_));
+	}
+	catch (const YAML::Exception& e)
+	{
+		throw std::runtime_error {path_ + ": deal at line " + std::to_string(item_line_) + ": " + e.what()};
+	}
+	++count_;
+	return true;
+}
+
+bool deal_reader::skip()
+{
+	switch (format_)
+	{
+	case format_t::binary:
+		if (binary_->size() <= count_)
+		{
+			return false;
+		}
+		++count_;
+		return true;
+	case format_t::pbn:
+		return read_pbn(nullptr);
+	case format_t::lin:
+		return read_lin(nullptr);
+	default:
+		break;
+	}
+
+	if (format_t::document == format_)
+	{
+		if (document_.end() == document_it_)
+		{
+			return false;
+		}
+		++document_it_;
+		++count_;
+		return true;
+	}
+
+	if (!read_item())
+	{
+		return false;
+	}
+	++count_;
+	return true;
+}
+
+bool deal_reader::read_item()
+{
+	if (!has_line_)
+	{
+		return false;
+	}
+
+	// "- key: value" becomes "  key: value", so the item is a mapping with unchanged indentation
+	item_line_ = line_number_;
+	item_.assign(" ");
+	item_.append(line_, 1, std::string::npos);
+	item_.push_back('\n');
+
+	while ((has_line_ = read_line()))
+	{
+		if (is_item_start(line_))
+		{
+			break;
+		}
+		if ((0 == line_.compare(0, 3, "---")) || (0 == line_.compare(0, 3, "...")))
+		{
+			continue;
+		}
+		item_.append(line_);
+		item_.push_back('\n');
+	}
+
+	return true;
+}
+
+// Games are separated by empty lines. Only the Deal tag is parsed for every game; Declarer, Dealer,
+// Contract and OptimumResultTable give the turn starter (left hand opponent of the declarer, otherwise
+// of the dealer, otherwise of the first hand of the deal), trump (no trump by default) and the stored
+// results.
+bool deal_reader::read_pbn(deal_t* deal)
+{
+	bool has_deal {false};
+	bool in_comment {false};
+	bool in_results {false};
+
+	uint64_t hands[4] {};
+	side_t first {side_t::North};
+	side_t declarer {side_t::North};
+	bool has_declarer {false};
+	side_t dealer {side_t::North};
+	bool has_dealer {false};
+	suit_t trump {suit_t::NoTrump};
+
+	// Tricks of the declarer; bit (declarer * 5 + strain) of results_mask is set for every entry read
+	uint8_t tricks[4][5] {};
+	uint32_t results_mask {0};
+
+	for (; has_line_; has_line_ = read_line())
+	{
+		if (in_comment)
+		{
+			in_comment = (std::string::npos == line_.find('}'));
+			continue;
+		}
+
+		const auto pos {line_.find_first_not_of(" \t")};
+		if (std::string::npos == pos)
+		{
+			if (has_deal)
+			{
+				has_line_ = read_line();
+				break;
+			}
+			continue;
+		}
+
+		const char c {line_[pos]};
+		if ('{' == c)
+		{
+			in_comment = (std::string::npos == line_.find('}', pos));
+			continue;
+		}
+		if ('[' != c)
+		{
+			if (in_results && ('%' != c) && (';' != c))
+			{
+				results_mask |= parse_result(line_, tricks);
+			}
+			continue;
+		}
+
+		in_results = false;
+
+		std::string_view name;
+		std::string_view value;
+		split_tag(line_, pos, name, value);
+		if ("Deal" == name)
+		{
+			// Next game without the empty line before it
+			if (has_deal)
+			{
+				break;
+			}
+
+			has_deal = true;
+			item_line_ = line_number_;
+			if ((nullptr != deal) && !deal_import::parse_pbn_deal(value.data(), value.data() + value.size(), hands, first))
+			{
+				throw std::runtime_error {path_ + ": deal at line " + std::to_string(item_line_) + ": invalid Deal tag"};
+			}
+		}
+		else if (nullptr == deal)
+		{
+			continue;
+		}
+		else if ("Declarer" == name)
+		{
+			const auto d {value.substr(((!value.empty()) && ('^' == value[0])) ? 1 : 0)};
+			has_declarer = (!d.empty()) && deal_import::parse_side(d[0], declarer);
+		}
+		else if ("Dealer" == name)
+		{
+			has_dealer = (!value.empty()) && deal_import::parse_side(value[0], dealer);
+		}
+		else if ("Contract" == name)
+		{
+			trump = suit_t::NoTrump;
+			if ((2 <= value.size()) && std::isdigit(static_cast<unsigned char>(value[0])))
+			{
+				deal_import::parse_strain(value[1], trump);
+			}
+		}
+		else if ("OptimumResultTable" == name)
+		{
+			in_results = true;
+		}
+	}
+
+	if (!has_deal)
+	{
+		return false;
+	}
+	++count_;
+
+	if (nullptr != deal)
+	{
+		moves_t moves;
+		moves.clear();
+		const side_t opened {has_declarer ? declarer : (has_dealer ? dealer : first)};
+		deal->table_ = first::table_t {hands, trump, opened + 1, moves};
+
+		// Stored results are tricks of NS by declarer (see table_processor_full)
+		deal->has_results_ = (0xFFFFF == results_mask);
+		if (deal->has_results_)
+		{
+			const auto max_tricks {static_cast<uint8_t>(deal->table_.max_tricks())};
+			for (const auto& side : side_t::all())
+			{
+				for (const auto& strain : suit_t::all())
+				{
+					const uint8_t t {tricks[side][strain]};
+					deal->results_[side][strain] = side.is_ns() ? t : static_cast<uint8_t>(max_tricks - t);
+				}
+			}
+		}
+	}
+	return true;
+}
+
+// Fields are "name|value|" pairs, every md field is a deal. Trump is no trump, the turn starter is
+// the left hand opponent of the dealer; LIN files have no results to compare with.
+bool deal_reader::read_lin(deal_t* deal)
+{
+	while (has_line_)
+	{
+		while (field_pos_ < line_.size())
+		{
+			const auto name_end {line_.find('|', field_pos_)};
+			if (std::string::npos == name_end)
+			{
+				break;
+			}
+
+			auto value_end {line_.find('|', name_end + 1)};
+			if (std::string::npos == value_end)
+			{
+				value_end = line_.size();
+			}
+
+			const auto name_begin {line_.find_first_not_of(" \t", field_pos_)};
+			const bool is_deal {((name_begin + 2) == name_end) && (0 == line_.compare(name_begin, 2, "md"))};
+			field_pos_ = value_end + 1;
+			if (!is_deal)
+			{
+				continue;
+			}
+
+			item_line_ = line_number_;
+			++count_;
+			if (nullptr == deal)
+			{
+				return true;
+			}
+
+			uint64_t hands[4] {};
+			side_t dealer {side_t::South};
+			if (!deal_import::parse_lin_deal(line_.data() + name_end + 1, line_.data() + value_end, hands, dealer))
+			{
+				throw std::runtime_error {path_ + ": deal at line " + std::to_string(item_line_) + ": invalid md field"};
+			}
+
+			moves_t moves;
+			moves.clear();
+			deal->table_ = first::table_t {hands, suit_t::NoTrump, dealer + 1, moves};
+			deal->has_results_ = false;
+			return true;
+		}
+
+		has_line_ = read_line();
+		field_pos_ = 0;
+	}
+	return false;
+}
+
+bool deal_reader::read_line()
+{
+	if (!std::getline(stream_, line_))
+	{
+		return false;
+	}
+	++line_number_;
+	if ((!line_.empty()) && ('\r' == line_.back()))
+	{
+		line_.pop_back();
+	}
+	return true;
+}
+
+bool deal_reader::is_item_start(const std::string& line) noexcept
+{
+	return (!line.empty()) && ('-' == line[0]) && ((1 == line.size()) || (' ' == line[1]) || ('\t' == line[1]) || ('\r' == line[1]));
+}
+
+bool deal_reader::is_ignored(const std::string& line) noexcept
+{
+	const auto pos {line.find_first_not_of(" \t\r")};
+	return (std::string::npos == pos) || ('#' == line[pos]) || ('%' == line[pos]) || (0 == line.compare(0, 3, "---"))
+		   || (0 == line.compare(0, 3, "..."));
+}
+
+bool deal_reader::is_pbn_tag(const std::string& line) noexcept
+{
+	// [Name "Value"]
+	const auto name_end {line.find_first_not_of("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789_", 1)};
+	return (!line.empty()) && ('[' == line[0]) && (1 < name_end) && (std::string::npos != name_end)
+		   && (' ' == line[name_end]) && (std::string::npos != line.find('"', name_end));
+}
+
+bool deal_reader::is_lin_field(const std::string& line) noexcept
+{
+	// Two letters name and '|'
+	return (3 <= line.size()) && std::islower(static_cast<unsigned char>(line[0]))
+		   && std::isalnum(static_cast<unsigned char>(line[1])) && ('|' == line[2]);
+}
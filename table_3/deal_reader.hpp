@@ -0,0 +1,98 @@
+#ifndef DEAL_READER_HPP
+#define DEAL_READER_HPP
+
+#include <cstddef>
+
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include <yaml-cpp/yaml.h>
+
+#include "deal.hpp"
+#include "deal_binary.hpp"
+
+/**
+ *****************************************************************************
+ * @brief The deal_reader class - reads deals of the file one by one, so the
+ * whole document is never kept in memory. Deal files are block sequences:
+ * every item starts with "- " in the first column and is parsed as a separate
+ * YAML document. Files of any other layout are loaded as a whole. Binary
+ * deal files (see deal_binary) are recognized by the header and mapped.
+ * PBN and BBO LIN files are recognized by the first line and parsed without
+ * YAML (see deal_import).
+ */
+class deal_reader
+{
+public:
+	// Throws std::runtime_error if the file can not be opened.
+	explicit deal_reader(const std::string& path);
+	~deal_reader() = default;
+
+	deal_reader(const deal_reader&) = delete;
+	deal_reader(deal_reader&&) = delete;
+	deal_reader& operator=(const deal_reader&) = delete;
+	deal_reader& operator=(deal_reader&&) = delete;
+
+public:
+	// Reads the next deal; returns false at the end of file. Throws std::runtime_error for
+	// invalid YAML or deal (with the line, where the deal starts).
+	bool next(deal_t& deal);
+
+	// Moves to the next deal without parsing it; returns false at the end of file.
+	bool skip();
+
+	// Number of deals read or skipped
+	inline std::size_t count() const noexcept
+	{
+		return count_;
+	}
+
+private:
+	enum class format_t
+	{
+		items,
+		document,
+		binary,
+		pbn,
+		lin,
+	};
+
+	bool next(YAML::Node& deal);
+
+	// Collects text of the next item into item_; returns false at the end of file.
+	bool read_item();
+
+	// Read tags of the next PBN game and the next LIN md field; deal is nullptr to skip it.
+	bool read_pbn(deal_t* deal);
+	bool read_lin(deal_t* deal);
+
+	bool read_line();
+
+	static bool is_item_start(const std::string& line) noexcept;
+	static bool is_ignored(const std::string& line) noexcept;
+	static bool is_pbn_tag(const std::string& line) noexcept;
+	static bool is_lin_field(const std::string& line) noexcept;
+
+private:
+	std::ifstream stream_;
+	std::string path_;
+	std::string line_;
+	std::string item_;
+	std::size_t line_number_ {0};
+	std::size_t item_line_ {0};
+	std::size_t count_ {0};
+	bool has_line_ {false};
+	format_t format_ {format_t::items};
+
+	// Position of the next LIN field in line_
+	std::size_t field_pos_ {0};
+
+	// Whole document for files, which are not block sequences
+	YAML::Node document_;
+	YAML::const_iterator document_it_;
+
+	std::unique_ptr<deal_binary::file> binary_;
+};
+
+#endif // DEAL_READER_HPP
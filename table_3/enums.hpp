@@ -6,6 +6,8 @@
 #include <array>
 #include <type_traits>
 
+#include "bits.hpp"
+
 /**
  *****************************************************************************
  * @brief The card_t struct - значение карты
@@ -59,6 +61,12 @@ struct card_t
 		return ((card_ << 1) == other.card_) || ((other.card_ << 1) == card_);
 	}
 
+	// Rank of the card: 0 for C_2 ... 12 for Ace
+	inline constexpr uint8_t index() const noexcept
+	{
+		return static_cast<uint8_t>(bits::lowest(card_));
+	}
+
 	static card_t next_card_from_string(const char*& str);
 
 	const char* to_string() const noexcept;
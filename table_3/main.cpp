@@ -1,24 +1,58 @@
 ﻿#include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 #include <yaml-cpp/yaml.h>
 
 #include <leveldb/db.h>
 
-#include "table_cache_memory.hpp"
+#include "deal_binary.hpp"
+#include "deal_reader.hpp"
+#include "process_pool.hpp"
+#include "progress.hpp"
+#include "result_writer.hpp"
+#include "table_cache_bounds.hpp"
+#include "table_cache_leveldb.hpp"
+#include "table_cache_lockfree.hpp"
+#include "table_cache_sharded.hpp"
+#include "table_cache_tt.hpp"
 #include "table_processor.hpp"
+#include "table_processor_ab.hpp"
+#include "thread_pool.hpp"
 
 #include "table_first.h"
+#include "table_second.hpp"
 
-using table_processor_type = table_processor<first::table_t, table_cache_memory<std::map>, true>;
-using table_cache_type = typename table_processor_type::cache_type;
+using table_cache_type = table_cache_leveldb<table_cache_tt<std::mutex>>;
+using table_processor_type = table_processor<first::table_t, table_cache_type, true>;
+using table_processor_second_type = table_processor<second::table_t, table_cache_type, false>;
+using table_cache_sharded_type = table_cache_leveldb<table_cache_sharded<std::unordered_map>>;
+using table_processor_sharded_type = table_processor<first::table_t, table_cache_sharded_type, true>;
+using table_processor_second_sharded_type = table_processor<second::table_t, table_cache_sharded_type, false>;
+using table_cache_bounds_type = table_cache_bounds<std::mutex>;
+using table_processor_ab_type = table_processor_ab<first::table_t, table_cache_bounds_type>;
+using table_processor_ab_second_type = table_processor_ab<second::table_t, table_cache_bounds_type>;
+using table_processor_ab_lockfree_type = table_processor_ab<first::table_t, table_cache_lockfree>;
+using table_processor_ab_second_lockfree_type = table_processor_ab<second::table_t, table_cache_lockfree>;
 using table_result_type = typename table_processor_type::result_type;
 
 void output_results(table_result_type& results)
@@ -28,7 +62,7 @@ void output_results(table_result_type& results)
 	{
 		std::cout << std::setw(10) << suit_t {trump};
 	}
-	std::cout << std::endl;
+	std::cout << '\n';
 
 	for (const auto& side : side_t::all())
 	{
@@ -37,55 +71,68 @@ void output_results(table_result_type& results)
 		{
 			std::cout << std::setw(10) << static_cast<int>(results[side][trump]);
 		}
-		std::cout << std::endl;
+		std::cout << '\n';
 	}
 }
 
-void compare_results(const YAML::Node& n, table_result_type& results)
+void compare_results(const deal_t& deal, table_result_type& results)
 {
-	try
+	if (!deal.has_results_)
 	{
-		const auto rc {n["Result"]};
-		side_t side_mismatch;
-		suit_t suit_mismatch;
-		if ([&]() {
-				for (const auto& side : side_t::all())
-				{
-					const auto src {rc[side.to_string_short()]};
-					for (const auto& trump : suit_t::all())
-					{
-						if (src[static_cast<uint8_t>(trump)].as<int>() != static_cast<int>(results[side][trump]))
-						{
-							side_mismatch = side;
-							suit_mismatch = trump;
-							return false;
-							break;
-						}
-					}
-				}
-				return true;
-			}())
-		{
-			std::cout << "Results match stored results." << std::endl;
-		}
-		else
+		std::cout << "Results to compare not found or invalid" << '\n';
+		return;
+	}
+
+	for (const auto& side : side_t::all())
+	{
+		for (const auto& trump : suit_t::all())
 		{
-			std::cout << "Results DOES NOT match stored results at ["
-					  << side_mismatch << ", " << suit_mismatch << "]" << std::endl;
+			if (deal.results_[side][trump] != results[side][trump])
+			{
+				std::cout << "Results DOES NOT match stored results at ["
+						  << side << ", " << suit_t {trump} << "]" << '\n';
+				return;
+			}
 		}
 	}
-	catch (const std::exception& e)
+
+	std::cout << "Results match stored results." << '\n';
+}
+
+// Writes results of the deal into the result file; results is nullptr for invalid deals
+void write_results(result_writer& writer, std::size_t number, const deal_t& deal, const table_result_type* results)
+{
+	if (nullptr == results)
 	{
-		std::cout << "Results to compare not found or invalid: " << e.what() << std::endl;
+		writer.write(number, deal, nullptr);
+		return;
 	}
+
+	uint8_t tricks[4][5];
+	for (const auto& side : side_t::all())
+	{
+		for (const auto& trump : suit_t::all())
+		{
+			tricks[side][trump] = results->at(side).at(trump);
+		}
+	}
+	writer.write(number, deal, tricks);
 }
 
-void process_table(const YAML::Node& n, table_cache_type& tc)
+template <typename ProcessorType>
+void process_table(const deal_t& deal, std::size_t number, ProcessorType tp, thread_pool* pool, std::size_t split_depth,
+				   result_writer* writer)
 {
-	first::table_t table {n};
+	tp.set_root_split(pool, split_depth);
+
+	typename ProcessorType::table_type table {deal.table_};
 	if (!table.is_valid())
 	{
 		table.dump();
+		if (nullptr != writer)
+		{
+			write_results(*writer, number, deal, nullptr);
+		}
 		return;
 	}
 
@@ -107,16 +154,22 @@ void process_table(const YAML::Node& n, table_cache_type& tc)
 
 	{
 		table.dump();
-		table_processor_type tp {tc};
-		auto results {tp.process_table_full(table)};
+		auto results {(nullptr != pool) ? tp.process_table_full(table, *pool) : tp.process_table_full(table)};
 
 		double ips {static_cast<double>(tp.total_iterations()) / static_cast<double>(tp.total_duration())};
 		std::cout << "Total took " << (tp.total_duration() / 1000) << " milliseconds ("
 				  << tp.total_iterations() << " iteration(s); "
-				  << ips << " Mips); " << tc.size() << " table(s) saved " << std::endl;
+				  << ips << " Mips); " << tp.cache_size() << " table(s) saved " << std::endl;
 
-		output_results(results);
-		compare_results(n, results);
+		if (nullptr != writer)
+		{
+			write_results(*writer, number, deal, &results);
+		}
+		else
+		{
+			output_results(results);
+		}
+		compare_results(deal, results);
 	}
 
 	//	uint64_t sm {table.simplify()};
@@ -148,34 +201,649 @@ void process_table(const YAML::Node& n, table_cache_type& tc)
 	//	}
 }
 
+// Solves every (deal, starter, trump) of the file as a separate task of the pool with the shared
+// cache; results of the deals are printed in input order as soon as all deals before them are done.
+// Deals are read while the previous ones are solved, at most a few deals per thread ahead.
+template <typename ProcessorType>
+void process_batch(deal_reader& reader, ProcessorType tp, thread_pool& pool, std::size_t split_depth,
+				   result_writer* writer)
+{
+	using namespace std::chrono;
+	using table_type = typename ProcessorType::table_type;
+
+	struct deal_state
+	{
+		deal_t deal_;
+		table_type table_;
+		table_result_type results_;
+		std::atomic<std::size_t> pending_ {0};
+		std::atomic<uint64_t> iterations_ {0};
+		bool done_ {false};
+	};
+
+	const std::size_t window {4 * pool.size()};
+
+	// Deals not printed yet; guarded by output_mutex
+	std::deque<deal_state> deals;
+	std::mutex output_mutex;
+	std::condition_variable cv_output;
+	std::size_t printed {0};
+	uint64_t total_iterations {0};
+
+	// Called under output_mutex
+	const auto flush_output {[&]() {
+		while (!deals.empty() && deals.front().done_)
+		{
+			auto& deal {deals.front()};
+			std::cout << std::string(40, '=') << '\n';
+			std::cout << "Table #" << (++printed) << '\n';
+			if (deal.table_.is_valid())
+			{
+				std::cout << deal.iterations_.load() << " iteration(s)" << '\n';
+				if (nullptr != writer)
+				{
+					write_results(*writer, printed, deal.deal_, &deal.results_);
+				}
+				else
+				{
+					output_results(deal.results_);
+				}
+				compare_results(deal.deal_, deal.results_);
+				total_iterations += deal.iterations_.load();
+			}
+			else
+			{
+				deal.table_.dump();
+				if (nullptr != writer)
+				{
+					write_results(*writer, printed, deal.deal_, nullptr);
+				}
+			}
+			std::cout << std::string(40, '=') << '\n';
+			std::cout << '\n';
+
+			deals.pop_front();
+		}
+		cv_output.notify_one();
+	}};
+
+	thread_pool::group group;
+	auto start {steady_clock::now()};
+
+	try
+	{
+		deal_t d;
+		while (reader.next(d))
+		{
+			table_type table {d.table_};
+
+			deal_state* deal {nullptr};
+			{
+				std::unique_lock<std::mutex> lock {output_mutex};
+				cv_output.wait(lock, [&]() { return deals.size() < window; });
+				deal = &deals.emplace_back();
+				deal->deal_ = d;
+				deal->table_ = table;
+
+				if (!table.is_valid())
+				{
+					deal->done_ = true;
+					flush_output();
+					continue;
+				}
+			}
+
+			// Results are created before the tasks start, so tasks only change their values
+			for (const auto& side : side_t::all())
+			{
+				for (const auto& trump : suit_t::all())
+				{
+					deal->results_[side][trump] = 0;
+				}
+			}
+			deal->pending_ = side_t::all().size() * suit_t::all().size();
+
+			for (const auto& side : side_t::all())
+			{
+				for (const auto& trump : suit_t::all())
+				{
+					pool.submit(group, [&, d = deal, side, trump]() {
+						auto worker {tp.worker()};
+						worker.set_root_split(&pool, split_depth);
+
+						auto t {d->table_};
+						t.set_starter(side + 1);
+						t.set_trump(trump);
+						d->results_.at(side).at(trump) = worker.process_table(t);
+						d->iterations_ += worker.iterations();
+
+						if (1 == d->pending_.fetch_sub(1))
+						{
+							std::lock_guard<std::mutex> lock {output_mutex};
+							d->done_ = true;
+							flush_output();
+						}
+					});
+				}
+			}
+		}
+	}
+	catch (...)
+	{
+		// Tasks refer to the deals, so they must finish first
+		pool.wait(group);
+		throw;
+	}
+
+	pool.wait(group);
+
+	const auto ms {duration_cast<milliseconds>(steady_clock::now() - start).count()};
+	std::cout << "Batch of " << printed << " table(s) took " << ms << " milliseconds ("
+			  << total_iterations << " iteration(s); " << pool.size() << " thread(s)); "
+			  << tp.cache_size() << " table(s) saved" << std::endl;
+}
+
+// Result of one deal sent by worker processes of process_forked()
+struct deal_record
+{
+	uint32_t index_;
+	uint8_t valid_;
+	uint8_t tricks_[4][5];
+	uint64_t iterations_;
+};
+
+static_assert(std::is_trivially_copyable_v<deal_record>);
+
+// Deals are split between processes (deal i goes to process i % processes), every process reads the
+// file itself (skipping deals of other processes) and solves its deals one by one with its own cache
+// and pool; results are printed in input order as in process_batch().
+template <typename WithProcessor>
+void process_forked(const std::string& path, std::size_t processes, std::size_t threads, std::size_t split_depth,
+					result_writer* writer, const WithProcessor& with_processor)
+{
+	using namespace std::chrono;
+
+	// Records received ahead of the printed ones
+	std::map<uint32_t, deal_record> records;
+	std::size_t printed {0};
+	uint64_t total_iterations {0};
+
+	// Deals are read again in the parent to compare results
+	deal_reader reader {path};
+
+	process_pool pp {processes, sizeof(deal_record)};
+	auto start {steady_clock::now()};
+
+	pp.run(
+		[&](std::size_t index, process_pool::channel& ch) {
+			std::unique_ptr<thread_pool> pool;
+			if (1 < threads)
+			{
+				pool = std::make_unique<thread_pool>(threads);
+			}
+
+			deal_reader own_reader {path};
+			with_processor(nullptr, pool.get(), true, [&](auto tp, auto& cache) {
+				tp.set_root_split(pool.get(), split_depth);
+
+				deal_t d;
+				for (std::size_t i = 0;; ++i)
+				{
+					if (index != (i % pp.size()))
+					{
+						if (!own_reader.skip())
+						{
+							break;
+						}
+						continue;
+					}
+
+					if (!own_reader.next(d))
+					{
+						break;
+					}
+
+					cache.new_generation();
+					tp.new_deal();
+
+					deal_record r {};
+					r.index_ = static_cast<uint32_t>(i);
+
+					typename decltype(tp)::table_type table {d.table_};
+					if (table.is_valid())
+					{
+						auto results {(nullptr != pool) ? tp.process_table_full(table, *pool) : tp.process_table_full(table)};
+						for (const auto& side : side_t::all())
+						{
+							for (const auto& trump : suit_t::all())
+							{
+								r.tricks_[side][trump] = results[side][trump];
+							}
+						}
+						r.valid_ = 1;
+						r.iterations_ = tp.total_iterations();
+					}
+
+					ch.send(&r, sizeof(r));
+				}
+			});
+		},
+		[&](std::size_t, const void* data) {
+			deal_record r;
+			std::memcpy(&r, data, sizeof(r));
+			records[r.index_] = r;
+
+			deal_t d;
+			for (auto it {records.find(static_cast<uint32_t>(printed))}; records.end() != it;
+				 it = records.find(static_cast<uint32_t>(printed)))
+			{
+				const auto record {it->second};
+				records.erase(it);
+				reader.next(d);
+
+				std::cout << std::string(40, '=') << '\n';
+				std::cout << "Table #" << (++printed) << '\n';
+				if (0 != record.valid_)
+				{
+					table_result_type results;
+					for (const auto& side : side_t::all())
+					{
+						for (const auto& trump : suit_t::all())
+						{
+							results[side][trump] = record.tricks_[side][trump];
+						}
+					}
+
+					std::cout << record.iterations_ << " iteration(s)" << '\n';
+					if (nullptr != writer)
+					{
+						writer->write(printed, d, record.tricks_);
+					}
+					else
+					{
+						output_results(results);
+					}
+					compare_results(d, results);
+					total_iterations += record.iterations_;
+				}
+				else
+				{
+					d.table_.dump();
+					if (nullptr != writer)
+					{
+						writer->write(printed, d, nullptr);
+					}
+				}
+				std::cout << std::string(40, '=') << '\n';
+				std::cout << '\n';
+			}
+		});
+
+	const auto ms {duration_cast<milliseconds>(steady_clock::now() - start).count()};
+	std::cout << "Batch of " << printed << " table(s) took " << ms << " milliseconds ("
+			  << total_iterations << " iteration(s); " << pp.size() << " process(es))" << std::endl;
+}
+
+void output_usage(const char* program)
+{
+	std::cout << "Usage: " << program << "  [-j threads] [-m cache_mb] [-d database|-] [-e exact|ab] [-t first|second] [-o none|heuristic|history] [-c locked|lockfree|sharded] [-s split_plies] [-y parallel_plies] [-b] [-q] [-p processes] [-w deals.bin] [-r results] [-f binary|csv|yaml] <tables.yml|deals.bin|deals.pbn|deals.lin>" << std::endl;
+}
+
+// Parses the decimal option value not less than min_value; signs, spaces and other characters are rejected.
+bool parse_count(const char* str, std::size_t min_value, std::size_t& value)
+{
+	if (!std::isdigit(static_cast<unsigned char>(str[0])))
+	{
+		return false;
+	}
+
+	char* end {nullptr};
+	errno = 0;
+	const auto v {std::strtoull(str, &end, 10)};
+	if (('\0' != *end) || (ERANGE == errno) || (v < min_value))
+	{
+		return false;
+	}
+	value = static_cast<std::size_t>(v);
+	return true;
+}
+
 int main(int argc, char** argv)
 {
-	std::unique_ptr<leveldb::DB> db;
+	std::size_t threads {1};
+	std::size_t cache_mb {256};
+	std::string database_path {"data/test_database"};
+	bool use_ab {false};
+	bool use_second {false};
+	move_ordering_t ordering {move_ordering_t::history};
+	bool use_lockfree {false};
+	bool use_sharded {false};
+	std::size_t split_depth {0};
+	std::size_t parallel_plies {0};
+	bool batch {false};
+	bool quiet {false};
+	std::size_t processes {1};
+	std::string binary_path;
+	std::string result_path;
+	result_format_t result_format {result_format_t::binary};
+	int arg {1};
+	for (; (arg < argc) && ('-' == argv[arg][0]); ++arg)
 	{
-		leveldb::DB* database {nullptr};
-		leveldb::DB::Open(leveldb::Options {}, "data/test_database", &database);
-		db.reset(database);
+		const std::string option {argv[arg]};
+		if (("-j" == option) && ((arg + 1) < argc))
+		{
+			if (!parse_count(argv[++arg], 1, threads))
+			{
+				std::cout << "Invalid value of " << option << ": " << argv[arg] << std::endl;
+				output_usage(argv[0]);
+				return 1;
+			}
+		}
+		else if (("-m" == option) && ((arg + 1) < argc))
+		{
+			if (!parse_count(argv[++arg], 1, cache_mb))
+			{
+				std::cout << "Invalid value of " << option << ": " << argv[arg] << std::endl;
+				output_usage(argv[0]);
+				return 1;
+			}
+		}
+		else if (("-d" == option) && ((arg + 1) < argc))
+		{
+			database_path = argv[++arg];
+		}
+		else if (("-e" == option) && ((arg + 1) < argc) && (("ab" == std::string {argv[arg + 1]})
+															|| ("exact" == std::string {argv[arg + 1]})))
+		{
+			use_ab = ("ab" == std::string {argv[++arg]});
+		}
+		else if (("-t" == option) && ((arg + 1) < argc) && (("first" == std::string {argv[arg + 1]})
+															|| ("second" == std::string {argv[arg + 1]})))
+		{
+			use_second = ("second" == std::string {argv[++arg]});
+		}
+		else if (("-c" == option) && ((arg + 1) < argc) && (("locked" == std::string {argv[arg + 1]})
+															|| ("lockfree" == std::string {argv[arg + 1]})
+															|| ("sharded" == std::string {argv[arg + 1]})))
+		{
+			use_lockfree = ("lockfree" == std::string {argv[arg + 1]});
+			use_sharded = ("sharded" == std::string {argv[++arg]});
+		}
+		else if (("-s" == option) && ((arg + 1) < argc))
+		{
+			if (!parse_count(argv[++arg], 0, split_depth))
+			{
+				std::cout << "Invalid value of " << option << ": " << argv[arg] << std::endl;
+				output_usage(argv[0]);
+				return 1;
+			}
+		}
+		else if (("-y" == option) && ((arg + 1) < argc))
+		{
+			if (!parse_count(argv[++arg], 0, parallel_plies))
+			{
+				std::cout << "Invalid value of " << option << ": " << argv[arg] << std::endl;
+				output_usage(argv[0]);
+				return 1;
+			}
+		}
+		else if (("-p" == option) && ((arg + 1) < argc))
+		{
+			if (!parse_count(argv[++arg], 1, processes))
+			{
+				std::cout << "Invalid value of " << option << ": " << argv[arg] << std::endl;
+				output_usage(argv[0]);
+				return 1;
+			}
+		}
+		else if ("-b" == option)
+		{
+			batch = true;
+		}
+		else if ("-q" == option)
+		{
+			quiet = true;
+		}
+		else if (("-w" == option) && ((arg + 1) < argc))
+		{
+			binary_path = argv[++arg];
+		}
+		else if (("-r" == option) && ((arg + 1) < argc))
+		{
+			result_path = argv[++arg];
+		}
+		else if (("-f" == option) && ((arg + 1) < argc))
+		{
+			try
+			{
+				result_format = result_format_from_string(argv[++arg]);
+			}
+			catch (const std::invalid_argument&)
+			{
+				std::cout << "Unknown result format: " << argv[arg] << std::endl;
+				return 1;
+			}
+		}
+		else if (("-o" == option) && ((arg + 1) < argc))
+		{
+			try
+			{
+				ordering = move_ordering_from_string(argv[++arg]);
+			}
+			catch (const std::invalid_argument&)
+			{
+				std::cout << "Unknown move ordering: " << argv[arg] << std::endl;
+				return 1;
+			}
+		}
+		else
+		{
+			std::cout << "Unknown option: " << option << std::endl;
+			return 1;
+		}
 	}
 
-	if (2 > argc)
+	if (arg >= argc)
 	{
-		std::cout << "Argument needed." << std::endl;
+		output_usage(argv[0]);
 		return 1;
 	}
 
+	// Conversion only: the deals are written in the binary format (see deal_binary) and not solved
+	if (!binary_path.empty())
+	{
+		try
+		{
+			deal_reader reader {argv[arg]};
+			deal_binary::writer writer {binary_path};
+
+			deal_t d;
+			while (reader.next(d))
+			{
+				writer.write(d);
+			}
+			writer.close();
+
+			std::cout << reader.count() << " deal(s) written into " << binary_path << std::endl;
+		}
+		catch (const std::exception& e)
+		{
+			std::cout << "Exception: " << e.what() << std::endl;
+			return 1;
+		}
+		return 0;
+	}
+
+	std::unique_ptr<leveldb::DB> db;
+	if (("-" != database_path) && (1 < processes))
+	{
+		std::cout << "Database is not used by worker processes" << std::endl;
+	}
+	else if ("-" != database_path)
+	{
+		leveldb::Options options {};
+		options.create_if_missing = true;
+
+		leveldb::DB* database {nullptr};
+		const auto status {leveldb::DB::Open(options, database_path, &database)};
+		db.reset(database);
+		if (!status.ok())
+		{
+			std::cout << "Database is not used: " << status.ToString() << std::endl;
+		}
+		else
+		{
+			// Tables stored in another format must not be read as the current ones
+			try
+			{
+				table_cache_leveldb_base::check_schema(db.get());
+			}
+			catch (const std::exception& e)
+			{
+				std::cout << "Database is not used: " << e.what() << std::endl;
+				db.reset();
+			}
+		}
+	}
+
 	try
 	{
-		table_cache_type tc {};
-		std::size_t index {0};
-		for (const auto& ts : YAML::LoadFile(argv[1]))
+		const std::size_t cache_budget {cache_mb * 1024 * 1024};
+
+		// Results go into the file instead of the console tables
+		std::unique_ptr<result_writer> writer;
+		if (!result_path.empty())
+		{
+			writer = std::make_unique<result_writer>(result_format, result_path);
+		}
+
+		// Calls func(processor, cache) with the processor selected by the options and a new cache of
+		// the processor; only this cache gets the memory budget.
+		const auto with_processor {[&](leveldb::DB* database, thread_pool* pool, bool quiet, auto&& func) {
+			// Bounded window processors search the first plies in parallel (see table_processor_ab)
+			const auto parallel {[&](auto tp) {
+				tp.set_parallel_plies(pool, parallel_plies);
+				return tp;
+			}};
+
+			if (use_ab && use_lockfree)
+			{
+				table_cache_lockfree tcl {cache_budget};
+				if (use_second)
+				{
+					func(parallel(table_processor_ab_second_lockfree_type {tcl, ordering, quiet}), tcl);
+				}
+				else
+				{
+					func(parallel(table_processor_ab_lockfree_type {tcl, ordering, quiet}), tcl);
+				}
+			}
+			else if (use_ab)
+			{
+				table_cache_bounds_type tcb {cache_budget};
+				if (use_second)
+				{
+					func(parallel(table_processor_ab_second_type {tcb, ordering, quiet}), tcb);
+				}
+				else
+				{
+					func(parallel(table_processor_ab_type {tcb, ordering, quiet}), tcb);
+				}
+			}
+			else
+			{
+				// Exact processors: transposition table of the budget size or maps locked by shards
+				const auto exact {[&](auto tp, auto& tc) {
+					func(tp, tc);
+
+					tc.flush();
+					if (nullptr != database)
+					{
+						std::cout << tc.loaded() << " table(s) loaded from database; "
+								  << tc.saved() << " table(s) saved into database" << std::endl;
+					}
+				}};
+
+				if (use_sharded)
+				{
+					// Shards keep all tables, the memory budget is not applied
+					table_cache_sharded_type tc {database};
+					if (use_second)
+					{
+						exact(table_processor_second_sharded_type {tc, quiet}, tc);
+					}
+					else
+					{
+						exact(table_processor_sharded_type {tc, quiet}, tc);
+					}
+				}
+				else
+				{
+					table_cache_type tc {database, cache_budget};
+					if (use_second)
+					{
+						exact(table_processor_second_type {tc, quiet}, tc);
+					}
+					else
+					{
+						exact(table_processor_type {tc, quiet}, tc);
+					}
+				}
+			}
+		}};
+
+		if (1 < processes)
+		{
+			process_forked(argv[arg], processes, threads, split_depth, writer.get(), with_processor);
+		}
+		else
 		{
-			std::cout << std::string(40, '=') << std::endl;
-			std::cout << "Table #" << (++index) << std::endl;
+			std::unique_ptr<thread_pool> pool;
+			if ((1 < threads) || batch)
+			{
+				pool = std::make_unique<thread_pool>(threads);
+			}
+
+			deal_reader reader {argv[arg]};
+			if (batch)
+			{
+				with_processor(db.get(), pool.get(), false, [&](auto tp, auto&) {
+					process_batch(reader, tp, *pool, split_depth, writer.get());
+				});
+			}
+			else
+			{
+				// Progress of the calculations is printed by the sampler thread, the search only counts nodes
+				std::unique_ptr<progress_sampler> progress;
+				if (!quiet)
+				{
+					progress = std::make_unique<progress_sampler>();
+				}
 
-			process_table(ts, tc);
+				with_processor(db.get(), pool.get(), quiet, [&](auto tp, auto& cache) {
+					tp.set_progress(progress.get());
 
-			std::cout << std::string(40, '=') << std::endl;
-			std::cout << std::endl;
+					deal_t d;
+					while (reader.next(d))
+					{
+						std::cout << std::string(40, '=') << std::endl;
+						std::cout << "Table #" << reader.count() << std::endl;
+
+						cache.new_generation();
+						tp.new_deal();
+						process_table(d, reader.count(), tp, pool.get(), split_depth, writer.get());
+
+						std::cout << std::string(40, '=') << std::endl;
+						std::cout << std::endl;
+					}
+				});
+			}
+		}
+
+		// Write errors are reported here: the destructor of the writer has to ignore them
+		if (nullptr != writer)
+		{
+			writer->flush();
 		}
 	}
 	catch (const std::exception& e)
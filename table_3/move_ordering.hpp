@@ -0,0 +1,213 @@
+#ifndef MOVE_ORDERING_HPP
+#define MOVE_ORDERING_HPP
+
+#include <cstdint>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "bits.hpp"
+#include "enums.hpp"
+
+enum class move_ordering_t
+{
+	none,      // Moves in order of get_available_moves()
+	heuristic, // Trick play rules (cash winners, 2nd hand low, 3rd hand high, ruff/discard)
+	history,   // Heuristic, equal moves ordered by cut offs they caused before
+};
+
+inline move_ordering_t move_ordering_from_string(const std::string& str)
+{
+	if ("none" == str)
+	{
+		return move_ordering_t::none;
+	}
+	if ("heuristic" == str)
+	{
+		return move_ordering_t::heuristic;
+	}
+	if ("history" == str)
+	{
+		return move_ordering_t::history;
+	}
+	throw std::invalid_argument {"unknown move ordering: " + str};
+}
+
+/**
+ *****************************************************************************
+ * @brief The move_orderer class - orders moves of the current player, so
+ * moves most probably deciding the search are tried first. Works with both
+ * tables through trick_size(), trick_move() and suit_cards().
+ */
+template <typename TableType>
+class move_orderer
+{
+public:
+	using table_type = TableType;
+	using move_type = typename table_type::move_type;
+	using moves_type = typename table_type::moves_type;
+
+public:
+	inline explicit move_orderer(move_ordering_t ordering = move_ordering_t::heuristic) noexcept
+		: ordering_ {ordering}
+	{
+	}
+
+	inline move_ordering_t ordering() const noexcept
+	{
+		return ordering_;
+	}
+
+	// History of the previous deal says nothing about the next one
+	inline void new_deal() noexcept
+	{
+		std::fill(&history_[0][0], &history_[0][0] + (sizeof(history_) / sizeof(history_[0][0])), 0u);
+	}
+
+	void order(const table_type& t, moves_type& moves) const noexcept
+	{
+		if ((move_ordering_t::none == ordering_) || (2 > moves.size()))
+		{
+			return;
+		}
+
+		const side_t player {t.current_player()};
+
+		int64_t keys[card_t::all().size()];
+		for (std::size_t i = 0; i < moves.size(); ++i)
+		{
+			keys[i] = static_cast<int64_t>(heuristic_score(t, moves[i])) * (int64_t {1} << 32);
+			if (move_ordering_t::history == ordering_)
+			{
+				keys[i] += history_[player][moves[i].index()];
+			}
+		}
+
+		// Insertion sort by descending key: there are 13 moves at most
+		for (std::size_t i = 1; i < moves.size(); ++i)
+		{
+			const auto m {moves[i]};
+			const auto key {keys[i]};
+			std::size_t j {i};
+			for (; (0 < j) && (keys[j - 1] < key); --j)
+			{
+				moves[j] = moves[j - 1];
+				keys[j] = keys[j - 1];
+			}
+			moves[j] = m;
+			keys[j] = key;
+		}
+	}
+
+	// Move m of the current player caused cut off
+	inline void cutoff(const table_type& t, const move_type& m) noexcept
+	{
+		if (move_ordering_t::history == ordering_)
+		{
+			const auto depth {static_cast<uint32_t>(t.max_tricks())};
+			history_[t.current_player()][m.index()] += depth * depth;
+		}
+	}
+
+private:
+	static inline bool is_higher(unsigned rank, uint16_t cards) noexcept
+	{
+		return (0 == (cards >> (rank + 1)));
+	}
+
+	static int heuristic_score(const table_type& t, const move_type& m) noexcept
+	{
+		const side_t player {t.current_player()};
+		const suit_t trump {t.trump()};
+		const bool is_nt {suit_t::NoTrump == trump};
+		const suit_t s {m.suit()};
+		const int rank {static_cast<int>(m.rank())};
+		const std::size_t position {t.trick_size()};
+
+		if (0 == position)
+		{
+			const uint16_t lho {t.suit_cards(player + 1, s)};
+			const uint16_t partner {t.suit_cards(player + 2, s)};
+			const uint16_t rho {t.suit_cards(player + 3, s)};
+
+			if (is_higher(m.rank(), lho | partner | rho))
+			{
+				// Winner, unless an opponent ruffs it
+				const bool ruffed {(!is_nt) && (s != trump)
+								   && (((0 == lho) && (0 != t.suit_cards(player + 1, trump)))
+									   || ((0 == rho) && (0 != t.suit_cards(player + 3, trump))))};
+				return ruffed ? (20 + rank) : (100 + rank);
+			}
+
+			// Low card to the winner of partner
+			if ((0 != partner) && is_higher(bits::highest(partner), lho | rho))
+			{
+				return 60 - rank;
+			}
+
+			return -rank;
+		}
+
+		const move_type& lead {t.trick_move(0)};
+		std::size_t winer {0};
+		for (std::size_t i = 1; i < position; ++i)
+		{
+			if (t.trick_move(i).is_beat(t.trick_move(winer), trump))
+			{
+				winer = i;
+			}
+		}
+
+		const bool partner_wins {(2 <= position) && ((position - 2) == winer)};
+		const bool beats {m.is_beat(t.trick_move(winer), trump)};
+
+		// The next player is the only opponent playing after the current one (if any)
+		const bool is_last {3 == position};
+		const uint16_t next_cards {is_last ? static_cast<uint16_t>(0) : t.suit_cards(player + 1, lead.suit())};
+
+		if (s == lead.suit())
+		{
+			if (partner_wins || (!beats))
+			{
+				return -rank;
+			}
+
+			if (is_last || is_higher(m.rank(), next_cards))
+			{
+				// Cheapest sure winner
+				return 100 - rank;
+			}
+
+			// Second hand low, third hand high
+			return (1 == position) ? -rank : (50 + rank);
+		}
+
+		if ((!is_nt) && (s == trump))
+		{
+			if (partner_wins)
+			{
+				return -50 - rank;
+			}
+
+			if (!beats)
+			{
+				return -60 - rank;
+			}
+
+			// Cheapest ruff, unless the next opponent can overruff
+			const bool overruff {(!is_last) && (0 == next_cards)
+								 && (!is_higher(m.rank(), t.suit_cards(player + 1, trump)))};
+			return overruff ? (40 - rank) : (90 - rank);
+		}
+
+		// Discard of the lowest card
+		return -rank;
+	}
+
+private:
+	move_ordering_t ordering_;
+	uint32_t history_[4][64] {};
+};
+
+#endif // MOVE_ORDERING_HPP
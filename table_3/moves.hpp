@@ -10,6 +10,13 @@
 
 #include "enums.hpp"
 
+/**
+ *****************************************************************************
+ * @brief The move_t class - card and tricks count packed into 16 bits:
+ * bits 0..3 - rank (0 for C_2 ... 12 for Ace), bits 4..5 - suit,
+ * bits 6..9 - tricks. Bits 0..5 together are the index of the card bit
+ * in 64-bit hand with 16 bits per suit.
+ */
 class move_t
 {
 public:
@@ -27,62 +34,77 @@ public:
 
 	template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
 	move_t(const card_t& c, const suit_t& s, T tr) noexcept
-		: total_ {0}
-		, tricks_ {static_cast<uint64_t>(tr)}
+		: value_ {static_cast<uint16_t>((static_cast<unsigned>(tr) << tricks_shift)
+										| (static_cast<unsigned>(static_cast<uint8_t>(s)) << suit_shift)
+										| c.index())}
 	{
-		cards_[s] = static_cast<uint16_t>(c);
+	}
+
+	// Move for the card with the given index (see index())
+	static inline move_t from_index(unsigned index) noexcept
+	{
+		move_t res;
+		res.value_ = static_cast<uint16_t>(index & index_mask);
+		return res;
 	}
 
 public:
-	inline suit_t suit() const
+	inline suit_t suit() const noexcept
+	{
+		return suit_t {(value_ >> suit_shift) & 0x03};
+	}
+
+	inline card_t card() const noexcept
 	{
-		return cards_[suit_t::Clubs]   ? suit_t::Clubs
-			: cards_[suit_t::Diamonds] ? suit_t::Diamonds
-			: cards_[suit_t::Hearts]   ? suit_t::Hearts
-									   : suit_t::Spades;
+		return card_t {static_cast<card_t::underlying_type>(1u << (value_ & rank_mask))};
 	}
 
-	inline card_t card() const
+	inline unsigned index() const noexcept
 	{
-		return cards_[suit_t::Clubs]   ? cards_[suit_t::Clubs]
-			: cards_[suit_t::Diamonds] ? cards_[suit_t::Diamonds]
-			: cards_[suit_t::Hearts]   ? cards_[suit_t::Hearts]
-									   : cards_[suit_t::Spades];
+		return value_ & index_mask;
+	}
+
+	inline unsigned rank() const noexcept
+	{
+		return value_ & rank_mask;
 	}
 
 	inline bool operator<(const move_t& other) const noexcept
 	{
-		return tricks_ < other.tricks_;
+		return (value_ >> tricks_shift) < (other.value_ >> tricks_shift);
 	}
 
 	inline uint8_t tricks() const noexcept
 	{
-		return static_cast<uint8_t>(tricks_);
+		return static_cast<uint8_t>(value_ >> tricks_shift);
 	}
 
 	inline bool is_beat(const move_t& m, const suit_t& trump) const noexcept
 	{
 		const auto s {suit()};
-		return (m.suit() == s) ? (card() > m.card()) : (trump == s);
+		return (m.suit() == s) ? ((value_ & rank_mask) > (m.value_ & rank_mask)) : (trump == s);
 	}
 
+	// Ranks 13..15 are never used, so cards of different suits are never neighbors
 	inline bool constexpr is_neighbor(const move_t& other) const noexcept
 	{
-		return ((total_ << 1) == other.total_) || ((other.total_ << 1) == total_);
+		const unsigned i {value_ & index_mask};
+		const unsigned oi {other.value_ & index_mask};
+		return ((i + 1) == oi) || ((oi + 1) == i);
 	}
 
 	template <typename T>
 	inline std::enable_if_t<std::is_integral_v<T>>
 	add_tricks(T to_add)
 	{
-		tricks_ += static_cast<uint64_t>(to_add);
+		value_ = static_cast<uint16_t>(value_ + (static_cast<unsigned>(to_add) << tricks_shift));
 	}
 
 	template <typename T>
 	inline std::enable_if_t<std::is_integral_v<T>>
 	set_tricks(T new_tricks)
 	{
-		tricks_ = static_cast<uint64_t>(new_tricks);
+		value_ = static_cast<uint16_t>((value_ & index_mask) | (static_cast<unsigned>(new_tricks) << tricks_shift));
 	}
 
 	inline std::string to_string() const
@@ -91,17 +113,17 @@ public:
 	}
 
 private:
-	union
-	{
-		uint64_t total_;
-		uint16_t cards_[4];
-	};
-	uint64_t tricks_;
+	static constexpr unsigned rank_mask {0x0F};
+	static constexpr unsigned index_mask {0x3F};
+	static constexpr unsigned suit_shift {4};
+	static constexpr unsigned tricks_shift {6};
+
+	uint16_t value_;
 };
 
 static_assert(std::is_trivial_v<move_t>);
-static_assert(sizeof(move_t) == (2 * sizeof(uint64_t)));
-static_assert(alignof(move_t) == alignof(uint64_t));
+static_assert(sizeof(move_t) == sizeof(uint16_t));
+static_assert(alignof(move_t) == alignof(uint16_t));
 
 class moves_t
 {
@@ -205,11 +227,11 @@ public:
 
 private:
 	move_t moves_[13];
-	std::size_t size_;
+	uint8_t size_;
 };
 
 static_assert(std::is_trivial_v<moves_t>);
-static_assert(sizeof(moves_t) == (27 * sizeof(uint64_t))); // 13 * 2 +1
-static_assert(alignof(moves_t) == alignof(uint64_t));
+static_assert(sizeof(moves_t) == (14 * sizeof(uint16_t))); // 13 + 1
+static_assert(alignof(moves_t) == alignof(uint16_t));
 
 #endif // MOVES_HPP
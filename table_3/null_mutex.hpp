@@ -0,0 +1,16 @@
+#ifndef NULL_MUTEX_HPP
+#define NULL_MUTEX_HPP
+
+// Lock type for caches which are used from the single thread only
+struct null_mutex
+{
+	inline void lock() noexcept
+	{
+	}
+
+	inline void unlock() noexcept
+	{
+	}
+};
+
+#endif // NULL_MUTEX_HPP
@@ -0,0 +1,200 @@
+#include "process_pool.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+void process_pool::channel::send(const void* data, std::size_t size)
+{
+	const char* p {static_cast<const char*>(data)};
+	while (0 != size)
+	{
+		const auto written {::write(fd_, p, size)};
+		if (0 > written)
+		{
+			if (EINTR == errno)
+			{
+				continue;
+			}
+			throw std::system_error {errno, std::generic_category(), "write to the pipe"};
+		}
+		p += written;
+		size -= static_cast<std::size_t>(written);
+	}
+}
+
+process_pool::process_pool(std::size_t processes, std::size_t record_size)
+	: processes_ {(0 == processes) ? 1 : processes}
+	, record_size_ {record_size}
+{
+}
+
+void process_pool::run(const worker_type& worker, const receiver_type& receiver)
+{
+	struct child
+	{
+		pid_t pid_ {-1};
+		int fd_ {-1};
+		std::vector<char> buffer_ {};
+	};
+
+	// Children still running when run() leaves by an exception are killed and reaped, their pipes closed
+	struct children_guard
+	{
+		std::vector<child>& children_;
+
+		~children_guard()
+		{
+			for (auto& c : children_)
+			{
+				if (0 <= c.fd_)
+				{
+					::close(c.fd_);
+				}
+				if (0 < c.pid_)
+				{
+					::kill(c.pid_, SIGKILL);
+					while ((0 > ::waitpid(c.pid_, nullptr, 0)) && (EINTR == errno))
+					{
+					}
+				}
+			}
+		}
+	};
+
+	// Buffered output would be written by every process otherwise
+	std::cout.flush();
+	std::cerr.flush();
+
+	std::vector<child> children(processes_);
+	children_guard guard {children};
+	for (std::size_t i = 0; i < processes_; ++i)
+	{
+		int fds[2];
+		if (0 != ::pipe(fds))
+		{
+			throw std::system_error {errno, std::generic_category(), "pipe"};
+		}
+
+		const pid_t pid {::fork()};
+		if (0 > pid)
+		{
+			const int error {errno};
+			::close(fds[0]);
+			::close(fds[1]);
+			throw std::system_error {error, std::generic_category(), "fork"};
+		}
+
+		if (0 == pid)
+		{
+			::close(fds[0]);
+			for (std::size_t j = 0; j < i; ++j)
+			{
+				::close(children[j].fd_);
+			}
+
+			int status {EXIT_SUCCESS};
+			try
+			{
+				channel ch {fds[1]};
+				worker(i, ch);
+			}
+			catch (const std::exception& e)
+			{
+				std::cerr << "Worker process #" << i << ": " << e.what() << std::endl;
+				status = EXIT_FAILURE;
+			}
+			std::cout.flush();
+			::close(fds[1]);
+
+			// Destructors of the parent objects must not run in the child
+			std::_Exit(status);
+		}
+
+		::close(fds[1]);
+		children[i].pid_ = pid;
+		children[i].fd_ = fds[0];
+	}
+
+	std::vector<char> chunk(record_size_ * 64);
+	std::size_t open {processes_};
+	std::vector<pollfd> pfds(processes_);
+	while (0 != open)
+	{
+		for (std::size_t i = 0; i < processes_; ++i)
+		{
+			pfds[i] = pollfd {children[i].fd_, POLLIN, 0};
+		}
+
+		if (0 > ::poll(pfds.data(), pfds.size(), -1))
+		{
+			if (EINTR == errno)
+			{
+				continue;
+			}
+			throw std::system_error {errno, std::generic_category(), "poll"};
+		}
+
+		for (std::size_t i = 0; i < processes_; ++i)
+		{
+			auto& c {children[i]};
+			if ((0 > c.fd_) || (0 == (pfds[i].revents & (POLLIN | POLLHUP | POLLERR))))
+			{
+				continue;
+			}
+
+			const auto got {::read(c.fd_, chunk.data(), chunk.size())};
+			if ((0 > got) && (EINTR == errno))
+			{
+				continue;
+			}
+			if (0 >= got)
+			{
+				::close(c.fd_);
+				c.fd_ = -1;
+				--open;
+				continue;
+			}
+
+			c.buffer_.insert(c.buffer_.end(), chunk.data(), chunk.data() + got);
+
+			std::size_t used {0};
+			for (; (used + record_size_) <= c.buffer_.size(); used += record_size_)
+			{
+				receiver(i, c.buffer_.data() + used);
+			}
+			c.buffer_.erase(c.buffer_.begin(), c.buffer_.begin() + static_cast<std::ptrdiff_t>(used));
+		}
+	}
+
+	std::string failed;
+	for (std::size_t i = 0; i < processes_; ++i)
+	{
+		int status {0};
+		while ((0 > ::waitpid(children[i].pid_, &status, 0)) && (EINTR == errno))
+		{
+		}
+		children[i].pid_ = -1;
+
+		if (!WIFEXITED(status) || (EXIT_SUCCESS != WEXITSTATUS(status)) || !children[i].buffer_.empty())
+		{
+			failed += (failed.empty() ? "#" : ", #") + std::to_string(i);
+		}
+	}
+
+	if (!failed.empty())
+	{
+		throw std::runtime_error {"worker process(es) failed: " + failed};
+	}
+}
@@ -0,0 +1,60 @@
+#ifndef PROCESS_POOL_HPP
+#define PROCESS_POOL_HPP
+
+#include <cstddef>
+
+#include <functional>
+
+/**
+ *****************************************************************************
+ * @brief The process_pool class - runs a function in forked worker processes
+ * (POSIX only). Every process sends fixed size records to the parent through
+ * its own pipe and the parent receives records of all processes as they come.
+ * Processes share nothing but the pipes, so each of them has its own caches.
+ */
+class process_pool
+{
+public:
+	class channel
+	{
+	public:
+		inline explicit channel(int fd) noexcept
+			: fd_ {fd}
+		{
+		}
+
+		// Writes the whole record; throws std::system_error on failure.
+		void send(const void* data, std::size_t size);
+
+	private:
+		int fd_;
+	};
+
+	using worker_type = std::function<void(std::size_t index, channel& ch)>;
+	using receiver_type = std::function<void(std::size_t index, const void* record)>;
+
+public:
+	process_pool(std::size_t processes, std::size_t record_size);
+	~process_pool() = default;
+
+	process_pool(const process_pool&) = delete;
+	process_pool(process_pool&&) = delete;
+	process_pool& operator=(const process_pool&) = delete;
+	process_pool& operator=(process_pool&&) = delete;
+
+public:
+	inline std::size_t size() const noexcept
+	{
+		return processes_;
+	}
+
+	// Runs worker in every process and calls receiver for every record sent by them (in the calling
+	// process). Throws std::runtime_error if any process can not be started or fails.
+	void run(const worker_type& worker, const receiver_type& receiver);
+
+private:
+	std::size_t processes_;
+	std::size_t record_size_;
+};
+
+#endif // PROCESS_POOL_HPP
@@ -0,0 +1,49 @@
+#include "progress.hpp"
+
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+progress_sampler::progress_sampler(std::chrono::milliseconds interval)
+	: interval_ {interval}
+	, thread_ {[this]() { run(); }}
+{
+}
+
+progress_sampler::~progress_sampler()
+{
+	{
+		std::lock_guard<std::mutex> lock {mutex_};
+		stop_ = true;
+	}
+	cv_.notify_one();
+	thread_.join();
+}
+
+void progress_sampler::attach(const sampled_counter* counter)
+{
+	std::lock_guard<std::mutex> lock {mutex_};
+	counter_ = counter;
+}
+
+void progress_sampler::detach(const sampled_counter* counter)
+{
+	std::lock_guard<std::mutex> lock {mutex_};
+	if (counter == counter_)
+	{
+		counter_ = nullptr;
+	}
+}
+
+void progress_sampler::run()
+{
+	std::unique_lock<std::mutex> lock {mutex_};
+	while (!cv_.wait_for(lock, interval_, [this]() { return stop_; }))
+	{
+		// Printed under the lock, so detach() waits for it and the owner prints after the counter
+		if (nullptr != counter_)
+		{
+			std::cout << std::setw(16) << counter_->load() << std::string(16, '\b') << std::flush;
+		}
+	}
+}
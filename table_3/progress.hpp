@@ -0,0 +1,113 @@
+#ifndef PROGRESS_HPP
+#define PROGRESS_HPP
+
+#include <cstdint>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/**
+ *****************************************************************************
+ * @brief The sampled_counter class - counter changed by its owner thread
+ * only and read by progress_sampler from another one. Changes are relaxed
+ * load and store, so they compile into plain moves (no locked instruction).
+ */
+class sampled_counter
+{
+public:
+	sampled_counter() = default;
+	~sampled_counter() = default;
+
+	inline sampled_counter(uint64_t value) noexcept
+		: value_ {value}
+	{
+	}
+
+	inline sampled_counter(const sampled_counter& other) noexcept
+		: value_ {other.load()}
+	{
+	}
+
+	inline sampled_counter& operator=(const sampled_counter& other) noexcept
+	{
+		store(other.load());
+		return *this;
+	}
+
+	inline sampled_counter& operator=(uint64_t value) noexcept
+	{
+		store(value);
+		return *this;
+	}
+
+	inline sampled_counter& operator++() noexcept
+	{
+		store(load() + 1);
+		return *this;
+	}
+
+	inline sampled_counter& operator+=(uint64_t value) noexcept
+	{
+		store(load() + value);
+		return *this;
+	}
+
+	inline operator uint64_t() const noexcept
+	{
+		return load();
+	}
+
+	inline uint64_t load() const noexcept
+	{
+		return value_.load(std::memory_order_relaxed);
+	}
+
+private:
+	inline void store(uint64_t value) noexcept
+	{
+		value_.store(value, std::memory_order_relaxed);
+	}
+
+private:
+	std::atomic<uint64_t> value_ {0};
+};
+
+/**
+ *****************************************************************************
+ * @brief The progress_sampler class - thread printing the attached counter
+ * periodically, so solvers do not check or print progress themselves. The
+ * counter is printed over itself (with backspaces) between the "started" and
+ * "finished" lines of the calculation.
+ */
+class progress_sampler
+{
+public:
+	explicit progress_sampler(std::chrono::milliseconds interval = std::chrono::milliseconds {250});
+	~progress_sampler();
+
+	progress_sampler(const progress_sampler&) = delete;
+	progress_sampler(progress_sampler&&) = delete;
+	progress_sampler& operator=(const progress_sampler&) = delete;
+	progress_sampler& operator=(progress_sampler&&) = delete;
+
+public:
+	// Counter is printed until it is detached; detach() returns after the last print is finished.
+	void attach(const sampled_counter* counter);
+	void detach(const sampled_counter* counter);
+
+private:
+	void run();
+
+private:
+	const std::chrono::milliseconds interval_;
+	const sampled_counter* counter_ {nullptr};
+	bool stop_ {false};
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::thread thread_;
+};
+
+#endif // PROGRESS_HPP
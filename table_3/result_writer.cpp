@@ -0,0 +1,242 @@
+#include "result_writer.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <algorithm>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+buffered_writer::buffered_writer(const std::string& path)
+	: buffer_ {new char[buffer_size]}
+{
+	fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (0 > fd_)
+	{
+		throw std::system_error {errno, std::generic_category(), "can not create result file \"" + path + "\""};
+	}
+}
+
+buffered_writer::~buffered_writer()
+{
+	try
+	{
+		flush();
+	}
+	catch (...)
+	{
+	}
+
+	::close(fd_);
+}
+
+void buffered_writer::write(const void* data, std::size_t size)
+{
+	const char* p {static_cast<const char*>(data)};
+	while (0 < size)
+	{
+		if (buffer_size == size_)
+		{
+			flush();
+		}
+		const std::size_t n {std::min(size, buffer_size - size_)};
+		std::memcpy(buffer_.get() + size_, p, n);
+		size_ += n;
+		p += n;
+		size -= n;
+	}
+}
+
+void buffered_writer::write_uint(uint64_t value)
+{
+	char digits[20];
+	std::size_t n {0};
+	do
+	{
+		digits[n++] = static_cast<char>('0' + (value % 10));
+		value /= 10;
+	} while (0 != value);
+
+	while (0 < n)
+	{
+		put(digits[--n]);
+	}
+}
+
+void buffered_writer::flush()
+{
+	std::size_t done {0};
+	while (done < size_)
+	{
+		const auto written {::write(fd_, buffer_.get() + done, size_ - done)};
+		if (0 > written)
+		{
+			if (EINTR == errno)
+			{
+				continue;
+			}
+
+			// Data not written stays in the buffer for the next flush()
+			const int error {errno};
+			std::memmove(buffer_.get(), buffer_.get() + done, size_ - done);
+			size_ -= done;
+			throw std::system_error {error, std::generic_category(), "can not write result file"};
+		}
+		done += static_cast<std::size_t>(written);
+	}
+	size_ = 0;
+}
+
+result_writer::result_writer(result_format_t format, const std::string& path)
+	: format_ {format}
+	, out_ {path}
+{
+	switch (format_)
+	{
+	case result_format_t::binary:
+	{
+		// Magic, version and record size as in deal_binary files; the number of records follows from the size
+		const uint32_t header[2] {binary_version, static_cast<uint32_t>(binary_record_size)};
+		out_.write(binary_magic, sizeof(binary_magic));
+		out_.write(header, sizeof(header));
+		break;
+	}
+	case result_format_t::csv:
+		out_.write("deal");
+		for (const auto& side : side_t::all())
+		{
+			for (const auto& trump : suit_t::all())
+			{
+				out_.put(',');
+				out_.write(side.to_string_short());
+				out_.put('_');
+				out_.write(trump.to_string_short());
+			}
+		}
+		out_.put('\n');
+		break;
+	case result_format_t::yaml:
+		break;
+	}
+}
+
+void result_writer::write(std::size_t number, const deal_t& deal, const uint8_t (*tricks)[5])
+{
+	switch (format_)
+	{
+	case result_format_t::binary:
+	{
+		// Deal number (little-endian), then tricks[declarer][trump] two per byte, lower nibble first
+		unsigned char record[binary_record_size];
+		for (std::size_t i = 0; i < 4; ++i)
+		{
+			record[i] = static_cast<unsigned char>(number >> (8 * i));
+		}
+		for (std::size_t i = 0; i < 20; i += 2)
+		{
+			const unsigned lower {(nullptr != tricks) ? tricks[i / 5][i % 5] : 0xFu};
+			const unsigned upper {(nullptr != tricks) ? tricks[(i + 1) / 5][(i + 1) % 5] : 0xFu};
+			record[4 + i / 2] = static_cast<unsigned char>((lower & 0xF) | ((upper & 0xF) << 4));
+		}
+		out_.write(record, sizeof(record));
+		break;
+	}
+	case result_format_t::csv:
+		out_.write_uint(number);
+		for (std::size_t i = 0; i < 20; ++i)
+		{
+			out_.put(',');
+			if (nullptr != tricks)
+			{
+				out_.write_uint(tricks[i / 5][i % 5]);
+			}
+		}
+		out_.put('\n');
+		break;
+	case result_format_t::yaml:
+		write_yaml(number, deal, tricks);
+		break;
+	}
+}
+
+void result_writer::write_yaml(std::size_t number, const deal_t& deal, const uint8_t (*tricks)[5])
+{
+	const auto& t {deal.table_};
+
+	out_.write("- Name: \"Table #");
+	out_.write_uint(number);
+	out_.write("\"\n");
+
+	for (const auto& side : side_t::all())
+	{
+		out_.write("  ");
+		out_.write(side.to_string_short());
+		out_.write(":\n");
+		for (const auto& suit : suit_t::all())
+		{
+			if (suit_t::NoTrump == suit)
+			{
+				continue;
+			}
+
+			out_.write("    ");
+			out_.write(suit.to_string_short());
+			out_.put(':');
+
+			// Higher cards first
+			const auto cards {t.suit_cards(side, suit)};
+			bool first {true};
+			for (auto it {card_t::all().rbegin()}; card_t::all().rend() != it; ++it)
+			{
+				if (0 != (cards & static_cast<uint16_t>(*it)))
+				{
+					if (first)
+					{
+						out_.put(' ');
+						first = false;
+					}
+					out_.write(it->to_string());
+				}
+			}
+			out_.put('\n');
+		}
+	}
+
+	out_.write("  T: ");
+	out_.write(t.trump().to_string_short());
+	out_.write("\n  TS: ");
+	out_.write(t.turn_starter().to_string_short());
+	out_.write("\n  M: [");
+	for (std::size_t i = 0; i < t.moves().size(); ++i)
+	{
+		if (0 != i)
+		{
+			out_.write(", ");
+		}
+		out_.write(t.moves()[i].to_string().c_str());
+	}
+	out_.write("]\n");
+
+	if (nullptr != tricks)
+	{
+		out_.write("  Result:\n");
+		for (const auto& side : side_t::all())
+		{
+			out_.write("    ");
+			out_.write(side.to_string_short());
+			out_.write(": [");
+			for (const auto& trump : suit_t::all())
+			{
+				if (0 != static_cast<uint8_t>(trump))
+				{
+					out_.put(',');
+				}
+				out_.write_uint(tricks[side][trump]);
+			}
+			out_.write("]\n");
+		}
+	}
+	out_.put('\n');
+}
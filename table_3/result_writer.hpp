@@ -0,0 +1,129 @@
+#ifndef RESULT_WRITER_HPP
+#define RESULT_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "deal.hpp"
+
+enum class result_format_t
+{
+	binary, // Header and 14-byte records: deal number and 20 nibbles of NS tricks
+	csv,    // Deal number and 20 columns of NS tricks ([declarer][trump]) per line
+	yaml,   // Deals with "Result:" as in deal files, so they can be read and compared again
+};
+
+inline result_format_t result_format_from_string(const std::string& str)
+{
+	if ("binary" == str)
+	{
+		return result_format_t::binary;
+	}
+	if ("csv" == str)
+	{
+		return result_format_t::csv;
+	}
+	if ("yaml" == str)
+	{
+		return result_format_t::yaml;
+	}
+	throw std::invalid_argument {"unknown result format: " + str};
+}
+
+/**
+ *****************************************************************************
+ * @brief The buffered_writer class - output into the file through its
+ * own buffer, numbers are formatted without iostream. Data is written only
+ * when the buffer is full and by flush().
+ */
+class buffered_writer
+{
+public:
+	static constexpr std::size_t buffer_size {64 * 1024};
+
+public:
+	// Throws std::system_error if the file can not be created.
+	explicit buffered_writer(const std::string& path);
+	~buffered_writer();
+
+	buffered_writer(const buffered_writer&) = delete;
+	buffered_writer(buffered_writer&&) = delete;
+	buffered_writer& operator=(const buffered_writer&) = delete;
+	buffered_writer& operator=(buffered_writer&&) = delete;
+
+public:
+	inline void put(char c)
+	{
+		if (buffer_size == size_)
+		{
+			flush();
+		}
+		buffer_[size_++] = c;
+	}
+
+	void write(const void* data, std::size_t size);
+
+	inline void write(const char* str)
+	{
+		while ('\0' != *str)
+		{
+			put(*(str++));
+		}
+	}
+
+	// Decimal representation
+	void write_uint(uint64_t value);
+
+	// Throws std::system_error if data can not be written; data not written stays in the buffer.
+	void flush();
+
+private:
+	int fd_ {-1};
+	std::unique_ptr<char[]> buffer_;
+	std::size_t size_ {0};
+};
+
+/**
+ *****************************************************************************
+ * @brief The result_writer class - writes results of solved deals in the
+ * selected format. Deals are numbered from 1 in input order; invalid deals
+ * are written without results (binary records have 0xF nibbles).
+ */
+class result_writer
+{
+public:
+	static constexpr char binary_magic[8] {'T', '3', 'R', 'S', 'L', 'T', 'S', '\0'};
+	static constexpr uint32_t binary_version {1};
+	static constexpr std::size_t binary_record_size {14};
+
+public:
+	result_writer(result_format_t format, const std::string& path);
+	~result_writer() = default;
+
+	result_writer(const result_writer&) = delete;
+	result_writer(result_writer&&) = delete;
+	result_writer& operator=(const result_writer&) = delete;
+	result_writer& operator=(result_writer&&) = delete;
+
+public:
+	// tricks are NS tricks for [declarer][trump], nullptr for invalid deals
+	void write(std::size_t number, const deal_t& deal, const uint8_t (*tricks)[5]);
+
+	inline void flush()
+	{
+		out_.flush();
+	}
+
+private:
+	void write_yaml(std::size_t number, const deal_t& deal, const uint8_t (*tricks)[5]);
+
+private:
+	const result_format_t format_;
+	buffered_writer out_;
+};
+
+#endif // RESULT_WRITER_HPP
@@ -0,0 +1,309 @@
+#ifndef TABLE_CACHE_BOUNDS_HPP
+#define TABLE_CACHE_BOUNDS_HPP
+
+#include <cstdint>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+#include "moves.hpp"
+#include "null_mutex.hpp"
+#include "table_hash.hpp"
+#include "table_key.hpp"
+
+/**
+ *****************************************************************************
+ * @brief The table_bounds class - lower and upper bounds of tricks for the
+ * table and the best move found (if any), packed into 4 bytes. Unlike the
+ * sorted moves lists, bounds stay valid after searches with narrow window.
+ */
+class table_bounds
+{
+public:
+	static constexpr uint8_t no_move {0xFF};
+
+public:
+	inline table_bounds() noexcept
+		: table_bounds {0, 0}
+	{
+	}
+
+	inline table_bounds(std::size_t lower, std::size_t upper, uint8_t best = no_move) noexcept
+		: lower_ {static_cast<uint8_t>(lower)}
+		, upper_ {static_cast<uint8_t>(upper)}
+		, best_ {best}
+	{
+	}
+
+	table_bounds(const table_bounds&) = default;
+	table_bounds(table_bounds&&) = default;
+	table_bounds& operator=(const table_bounds&) = default;
+	table_bounds& operator=(table_bounds&&) = default;
+	~table_bounds() = default;
+
+public:
+	inline std::size_t lower() const noexcept
+	{
+		return lower_;
+	}
+
+	inline std::size_t upper() const noexcept
+	{
+		return upper_;
+	}
+
+	inline bool has_best_move() const noexcept
+	{
+		return (no_move != best_);
+	}
+
+	inline move_t best_move() const noexcept
+	{
+		return move_t::from_index(best_);
+	}
+
+	inline void set_best_move(const move_t& m) noexcept
+	{
+		best_ = static_cast<uint8_t>(m.index());
+	}
+
+	// The same bounds for the other side
+	inline table_bounds reversed(std::size_t max_tricks) const noexcept
+	{
+		return table_bounds {max_tricks - upper_, max_tricks - lower_, best_};
+	}
+
+	// Both bounds are true, so the result is their intersection
+	inline void merge(const table_bounds& other) noexcept
+	{
+		lower_ = std::max(lower_, other.lower_);
+		upper_ = std::min(upper_, other.upper_);
+		if (other.has_best_move())
+		{
+			best_ = other.best_;
+		}
+	}
+
+private:
+	uint8_t lower_;
+	uint8_t upper_;
+	uint8_t best_;
+	uint8_t reserved_ {0};
+};
+
+static_assert(4 == sizeof(table_bounds));
+
+/**
+ *****************************************************************************
+ * @brief The table_cache_bounds class - fixed size transposition table of
+ * table_bounds (see table_cache_tt for buckets and replacement). As in other
+ * caches, tables are stored relative to the turn starter: bounds are kept for
+ * the opponents of the starter and reversed, when NS starts the trick.
+ */
+template <typename MutexType = null_mutex>
+class table_cache_bounds
+{
+public:
+	using bounds_type = table_bounds;
+
+	static constexpr std::size_t bucket_slots {4};
+
+public:
+	explicit table_cache_bounds(std::size_t memory_budget)
+		: buckets_count_ {buckets_for_budget(memory_budget)}
+		, buckets_ {new bucket[buckets_count_] {}}
+	{
+	}
+
+	~table_cache_bounds() = default;
+
+	table_cache_bounds(const table_cache_bounds&) = delete;
+	table_cache_bounds(table_cache_bounds&&) = delete;
+	table_cache_bounds& operator=(const table_cache_bounds&) = delete;
+	table_cache_bounds& operator=(table_cache_bounds&&) = delete;
+
+public:
+	class entry_type
+	{
+	public:
+		entry_type() = default;
+		entry_type(const entry_type&) = default;
+		entry_type(entry_type&&) = default;
+		entry_type& operator=(const entry_type&) = default;
+		entry_type& operator=(entry_type&&) = default;
+		~entry_type() = default;
+
+		inline entry_type(table_cache_bounds* cache, const table_key& key, bool reverse, std::size_t max_tricks) noexcept
+			: cache_ {cache}
+			, key_ {key}
+			, max_tricks_ {max_tricks}
+			, reverse_ {reverse}
+		{
+		}
+
+	public:
+		inline bool valid() const noexcept
+		{
+			return (nullptr != cache_);
+		}
+
+		// Bounds of NS tricks found by the search; they are merged with stored ones
+		inline void update(const bounds_type& bounds)
+		{
+			if (nullptr != cache_)
+			{
+				auto stored {reverse_ ? bounds.reversed(max_tricks_) : bounds};
+				if (stored.has_best_move())
+				{
+					stored.set_best_move(key_.stored_move(stored.best_move()));
+				}
+				cache_->store(key_.hash(), key_.trump(), max_tricks_, stored);
+			}
+		}
+
+	private:
+		table_cache_bounds* cache_ {nullptr};
+		table_key key_;
+		std::size_t max_tricks_ {0};
+		bool reverse_ {false};
+	};
+
+	static_assert(std::is_trivially_copyable_v<entry_type>);
+
+public:
+	inline std::size_t size() const
+	{
+		std::lock_guard<MutexType> lock {mutex_};
+		return used_;
+	}
+
+	inline std::size_t capacity() const noexcept
+	{
+		return buckets_count_ * bucket_slots;
+	}
+
+	// Marks all stored tables as older than the ones stored from now on
+	inline void new_generation() noexcept
+	{
+		std::lock_guard<MutexType> lock {mutex_};
+		++generation_;
+	}
+
+	// Returns bounds of NS tricks; bounds are [0, max_tricks] for unknown tables.
+	template <typename TableType>
+	entry_type get_entry(bounds_type& bounds, const TableType& table)
+	{
+		const auto max_tricks {table.max_tricks()};
+		bounds = bounds_type {0, max_tricks};
+
+		if ((3 > max_tricks) || (!table.is_first_move()))
+		{
+			return entry_type {};
+		}
+
+		table_key key;
+		table.get_key(key);
+
+		const bool reverse {table.current_player().is_ns()};
+
+		{
+			std::lock_guard<MutexType> lock {mutex_};
+
+			const slot* s {find(buckets_[key.hash().hash() & (buckets_count_ - 1)], key.hash())};
+			if (nullptr != s)
+			{
+				bounds = reverse ? s->bounds_[key.trump()].reversed(max_tricks) : s->bounds_[key.trump()];
+			}
+		}
+		if (bounds.has_best_move())
+		{
+			bounds.set_best_move(key.table_move(bounds.best_move()));
+		}
+
+		return entry_type {this, key, reverse, max_tricks};
+	}
+
+private:
+	struct slot
+	{
+		table_hash hash_;
+		uint8_t depth_; // 0 for empty slot
+		uint8_t generation_;
+		bounds_type bounds_[5];
+	};
+
+	struct bucket
+	{
+		slot slots_[bucket_slots];
+	};
+
+	static std::size_t buckets_for_budget(std::size_t memory_budget) noexcept
+	{
+		std::size_t res {1};
+		while ((res * 2 * sizeof(bucket)) <= memory_budget)
+		{
+			res *= 2;
+		}
+		return res;
+	}
+
+	static inline slot* find(bucket& b, const table_hash& hash) noexcept
+	{
+		for (auto& s : b.slots_)
+		{
+			if ((0 != s.depth_) && (s.hash_ == hash))
+			{
+				return &s;
+			}
+		}
+		return nullptr;
+	}
+
+	void store(const table_hash& hash, suit_t trump, std::size_t depth, const bounds_type& bounds)
+	{
+		std::lock_guard<MutexType> lock {mutex_};
+
+		auto& b {buckets_[hash.hash() & (buckets_count_ - 1)]};
+		slot* s {find(b, hash)};
+		if (nullptr == s)
+		{
+			s = &b.slots_[0];
+			for (auto& candidate : b.slots_)
+			{
+				if (0 == candidate.depth_)
+				{
+					s = &candidate;
+					++used_;
+					break;
+				}
+
+				// Prefer tables of older generations, then tables with less tricks left
+				const uint8_t age {static_cast<uint8_t>(generation_ - candidate.generation_)};
+				const uint8_t s_age {static_cast<uint8_t>(generation_ - s->generation_)};
+				if ((age > s_age) || ((age == s_age) && (candidate.depth_ < s->depth_)))
+				{
+					s = &candidate;
+				}
+			}
+
+			std::fill(std::begin(s->bounds_), std::end(s->bounds_), bounds_type {0, depth});
+			s->hash_ = hash;
+			s->depth_ = static_cast<uint8_t>(depth);
+		}
+
+		s->generation_ = generation_;
+		s->bounds_[trump].merge(bounds);
+	}
+
+private:
+	const std::size_t buckets_count_;
+	std::unique_ptr<bucket[]> buckets_;
+	std::size_t used_ {0};
+	uint8_t generation_ {0};
+	mutable MutexType mutex_;
+};
+
+#endif // TABLE_CACHE_BOUNDS_HPP
@@ -0,0 +1,163 @@
+#include "table_cache_leveldb.hpp"
+
+#include <memory>
+#include <stdexcept>
+
+namespace
+{
+
+// Keys of tables are the hash and the trump, so this key of another length can not be one of them
+constexpr char schema_key[] {"table_3.schema"};
+static_assert((sizeof(schema_key) - 1) != (table_hash::size() + 1), "schema key must differ from keys of tables");
+
+} // namespace
+
+void table_cache_leveldb_base::check_schema(leveldb::DB* db)
+{
+	const std::string expected {std::to_string(schema_version)};
+
+	std::string value;
+	const auto status {db->Get(leveldb::ReadOptions {}, schema_key, &value)};
+	if (status.ok())
+	{
+		if (expected != value)
+		{
+			throw std::runtime_error {"database has tables of schema version " + value + ", version " + expected
+									  + " is expected"};
+		}
+		return;
+	}
+	if (!status.IsNotFound())
+	{
+		throw std::runtime_error {"can not read schema of database: " + status.ToString()};
+	}
+
+	std::unique_ptr<leveldb::Iterator> it {db->NewIterator(leveldb::ReadOptions {})};
+	it->SeekToFirst();
+	if (it->Valid())
+	{
+		throw std::runtime_error {"database has tables without schema version (stored by an older version)"};
+	}
+
+	const auto put_status {db->Put(leveldb::WriteOptions {}, schema_key, expected)};
+	if (!put_status.ok())
+	{
+		throw std::runtime_error {"can not write schema of database: " + put_status.ToString()};
+	}
+}
+
+table_cache_leveldb_base::table_cache_leveldb_base(leveldb::DB* db, std::size_t batch_size) noexcept
+	: db_ {db}
+	, batch_size_ {batch_size}
+{
+}
+
+table_cache_leveldb_base::~table_cache_leveldb_base()
+{
+	try
+	{
+		flush();
+	}
+	catch (...)
+	{
+		// Nothing to do: cache is not required to be saved
+	}
+}
+
+void table_cache_leveldb_base::flush()
+{
+	std::lock_guard<std::mutex> lock {mutex_};
+	flush_locked();
+}
+
+void table_cache_leveldb_base::flush_locked()
+{
+	if ((nullptr == db_) || (0 == pending_))
+	{
+		return;
+	}
+
+	const auto status {db_->Write(leveldb::WriteOptions {}, &batch_)};
+	batch_.Clear();
+	pending_ = 0;
+
+	if (!status.ok())
+	{
+		throw std::runtime_error {"can not write cache into database: " + status.ToString()};
+	}
+}
+
+bool table_cache_leveldb_base::load(const table_key& key, moves_t& moves)
+{
+	std::string value;
+	const auto status {db_->Get(leveldb::ReadOptions {}, make_key(key), &value)};
+	if (status.IsNotFound())
+	{
+		return false;
+	}
+
+	if ((!status.ok()) || (!decode(value, moves)))
+	{
+		throw std::runtime_error {"can not read cache from database: " + status.ToString()};
+	}
+
+	std::lock_guard<std::mutex> lock {mutex_};
+	++loaded_;
+	return true;
+}
+
+void table_cache_leveldb_base::save(const table_key& key, const moves_t& moves)
+{
+	const auto db_key {make_key(key)};
+	const auto value {encode(moves)};
+
+	std::lock_guard<std::mutex> lock {mutex_};
+	batch_.Put(db_key, value);
+	++saved_;
+	if ((++pending_) >= batch_size_)
+	{
+		flush_locked();
+	}
+}
+
+std::string table_cache_leveldb_base::make_key(const table_key& key)
+{
+	std::string res(reinterpret_cast<const char*>(key.hash().data()), table_hash::size());
+	res.push_back(static_cast<char>(static_cast<uint8_t>(key.trump())));
+	return res;
+}
+
+// Every move is stored as two bytes: card index (suit and rank, see move_t) and tricks.
+std::string table_cache_leveldb_base::encode(const moves_t& moves)
+{
+	std::string value;
+	value.reserve(moves.size() * 2);
+	for (const auto& m : moves)
+	{
+		value.push_back(static_cast<char>(m.index()));
+		value.push_back(static_cast<char>(m.tricks()));
+	}
+	return value;
+}
+
+bool table_cache_leveldb_base::decode(const std::string& value, moves_t& moves)
+{
+	moves.clear();
+	if ((0 != (value.size() % 2)) || ((card_t::all().size() * 2) < value.size()))
+	{
+		return false;
+	}
+
+	for (std::size_t i = 0; i < value.size(); i += 2)
+	{
+		const auto index {static_cast<uint8_t>(value[i])};
+		if ((card_t::all().size() <= (index & 0x0F)) || (0x3F < index))
+		{
+			return false;
+		}
+		auto m {move_t::from_index(index)};
+		m.set_tricks(static_cast<uint8_t>(value[i + 1]));
+		moves.push_back(m);
+	}
+	return true;
+}
@@ -0,0 +1,207 @@
+#ifndef TABLE_CACHE_LEVELDB_HPP
+#define TABLE_CACHE_LEVELDB_HPP
+
+#include <cstdint>
+
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include <leveldb/db.h>
+#include <leveldb/write_batch.h>
+
+#include "moves.hpp"
+#include "table_hash.hpp"
+#include "table_key.hpp"
+
+/**
+ *****************************************************************************
+ * @brief The table_cache_leveldb_base class - persistent part of the
+ * table_cache_leveldb: read-through lookups and batched writes.
+ */
+class table_cache_leveldb_base
+{
+public:
+	~table_cache_leveldb_base();
+
+	table_cache_leveldb_base(const table_cache_leveldb_base&) = delete;
+	table_cache_leveldb_base(table_cache_leveldb_base&&) = delete;
+	table_cache_leveldb_base& operator=(const table_cache_leveldb_base&) = delete;
+	table_cache_leveldb_base& operator=(table_cache_leveldb_base&&) = delete;
+
+public:
+	// Version of keys and values of the stored tables, kept in the schema record of the database.
+	static constexpr uint32_t schema_version {1};
+
+	// Writes the schema record into a new (empty) database. Throws std::runtime_error if the database
+	// has a schema record of another version, or tables without the record (stored by older builds).
+	static void check_schema(leveldb::DB* db);
+
+	// Writes all pending entries into database.
+	void flush();
+
+	inline uint64_t loaded() const noexcept
+	{
+		return loaded_;
+	}
+
+	inline uint64_t saved() const noexcept
+	{
+		return saved_;
+	}
+
+protected:
+	table_cache_leveldb_base(leveldb::DB* db, std::size_t batch_size) noexcept;
+
+	inline bool is_persistent() const noexcept
+	{
+		return (nullptr != db_);
+	}
+
+	// Both methods work with moves as they are stored in cache (see table_key).
+	bool load(const table_key& key, moves_t& moves);
+	void save(const table_key& key, const moves_t& moves);
+
+private:
+	static std::string make_key(const table_key& key);
+	static std::string encode(const moves_t& moves);
+	static bool decode(const std::string& value, moves_t& moves);
+
+	void flush_locked();
+
+private:
+	leveldb::DB* db_;
+	const std::size_t batch_size_;
+
+	std::mutex mutex_;
+	leveldb::WriteBatch batch_;
+	std::size_t pending_ {0};
+	uint64_t loaded_ {0};
+	uint64_t saved_ {0};
+};
+
+/**
+ *****************************************************************************
+ * @brief The table_cache_leveldb class - in-memory cache (table_cache_memory
+ * or table_cache_tt) with persistent LevelDB store under it. Tables missing
+ * in memory are looked up in database; calculated tables are written into
+ * database in batches. With null database works as the memory cache alone.
+ */
+template <typename MemoryCacheType>
+class table_cache_leveldb : public table_cache_leveldb_base
+{
+public:
+	using memory_cache_type = MemoryCacheType;
+	using memory_entry_type = typename memory_cache_type::entry_type;
+
+	static constexpr std::size_t default_batch_size {4096};
+
+public:
+	template <typename... Args>
+	explicit table_cache_leveldb(leveldb::DB* db, Args&&... args)
+		: table_cache_leveldb_base {db, default_batch_size}
+		, memory_ {std::forward<Args>(args)...}
+	{
+	}
+
+	~table_cache_leveldb() = default;
+
+public:
+	class entry_type
+	{
+	public:
+		entry_type() = default;
+		entry_type(const entry_type&) = default;
+		entry_type(entry_type&&) = default;
+		entry_type& operator=(const entry_type&) = default;
+		entry_type& operator=(entry_type&&) = default;
+		~entry_type() = default;
+
+		inline explicit entry_type(const memory_entry_type& memory_entry) noexcept
+			: memory_entry_ {memory_entry}
+		{
+		}
+
+		inline entry_type(const memory_entry_type& memory_entry, table_cache_leveldb* cache,
+						  const table_key& key, bool reverse, std::size_t max_tricks) noexcept
+			: memory_entry_ {memory_entry}
+			, cache_ {cache}
+			, key_ {key}
+			, max_tricks_ {max_tricks}
+			, reverse_ {reverse}
+		{
+		}
+
+	public:
+		inline bool valid() const noexcept
+		{
+			return memory_entry_.valid();
+		}
+
+		inline void update(const moves_t& moves)
+		{
+			memory_entry_.update(moves);
+
+			if (nullptr != cache_)
+			{
+				moves_t stored;
+				key_.to_stored(moves, stored, reverse_, max_tricks_);
+				cache_->save(key_, stored);
+			}
+		}
+
+	private:
+		memory_entry_type memory_entry_ {};
+		table_cache_leveldb* cache_ {nullptr};
+		table_key key_;
+		std::size_t max_tricks_ {0};
+		bool reverse_ {false};
+	};
+
+public:
+	inline std::size_t size() const
+	{
+		return memory_.size();
+	}
+
+	inline memory_cache_type& memory() noexcept
+	{
+		return memory_;
+	}
+
+	inline void new_generation()
+	{
+		memory_.new_generation();
+	}
+
+	template <typename TableType>
+	entry_type get_entry(moves_t& moves, const TableType& table)
+	{
+		auto memory_entry {memory_.get_entry(moves, table)};
+		if ((!memory_entry.valid()) || (!moves.empty()) || (!is_persistent()))
+		{
+			return entry_type {memory_entry};
+		}
+
+		table_key key;
+		table.get_key(key);
+
+		const bool reverse {table.current_player().is_ns()};
+		const auto max_tricks {table.max_tricks()};
+
+		moves_t stored;
+		if (load(key, stored))
+		{
+			key.from_stored(stored, moves, reverse, max_tricks);
+			memory_entry.update(moves);
+			return entry_type {memory_entry};
+		}
+
+		return entry_type {memory_entry, this, key, reverse, max_tricks};
+	}
+
+private:
+	memory_cache_type memory_;
+};
+
+#endif // TABLE_CACHE_LEVELDB_HPP
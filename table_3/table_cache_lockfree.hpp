@@ -0,0 +1,277 @@
+#ifndef TABLE_CACHE_LOCKFREE_HPP
+#define TABLE_CACHE_LOCKFREE_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#include <atomic>
+#include <memory>
+
+#include "moves.hpp"
+#include "table_cache_bounds.hpp"
+#include "table_hash.hpp"
+#include "table_key.hpp"
+
+/**
+ *****************************************************************************
+ * @brief The table_cache_lockfree class - transposition table of bounds
+ * (same contract as table_cache_bounds) without locks. Every slot is two
+ * 64-bit words written with relaxed atomics: payload and key XOR payload.
+ * Slot written by two threads at once fails the key check on read and is
+ * treated as missing, so races lose entries instead of corrupting them.
+ * Unlike table_cache_bounds, every strain is a separate slot and tables are
+ * identified by 64-bit key only.
+ */
+class table_cache_lockfree
+{
+public:
+	using bounds_type = table_bounds;
+
+	static constexpr std::size_t bucket_slots {4};
+
+public:
+	explicit table_cache_lockfree(std::size_t memory_budget)
+		: buckets_count_ {buckets_for_budget(memory_budget)}
+		, buckets_ {new bucket[buckets_count_] {}}
+	{
+	}
+
+	~table_cache_lockfree() = default;
+
+	table_cache_lockfree(const table_cache_lockfree&) = delete;
+	table_cache_lockfree(table_cache_lockfree&&) = delete;
+	table_cache_lockfree& operator=(const table_cache_lockfree&) = delete;
+	table_cache_lockfree& operator=(table_cache_lockfree&&) = delete;
+
+public:
+	class entry_type
+	{
+	public:
+		entry_type() = default;
+		entry_type(const entry_type&) = default;
+		entry_type(entry_type&&) = default;
+		entry_type& operator=(const entry_type&) = default;
+		entry_type& operator=(entry_type&&) = default;
+		~entry_type() = default;
+
+		inline entry_type(table_cache_lockfree* cache, uint64_t hash, const table_key& key, bool reverse,
+						  std::size_t max_tricks) noexcept
+			: cache_ {cache}
+			, hash_ {hash}
+			, key_ {key}
+			, max_tricks_ {max_tricks}
+			, reverse_ {reverse}
+		{
+		}
+
+	public:
+		inline bool valid() const noexcept
+		{
+			return (nullptr != cache_);
+		}
+
+		// Bounds of NS tricks found by the search; they are merged with stored ones
+		inline void update(const bounds_type& bounds)
+		{
+			if (nullptr != cache_)
+			{
+				auto stored {reverse_ ? bounds.reversed(max_tricks_) : bounds};
+				if (stored.has_best_move())
+				{
+					stored.set_best_move(key_.stored_move(stored.best_move()));
+				}
+				cache_->store(hash_, max_tricks_, stored);
+			}
+		}
+
+	private:
+		table_cache_lockfree* cache_ {nullptr};
+		uint64_t hash_ {0};
+		table_key key_;
+		std::size_t max_tricks_ {0};
+		bool reverse_ {false};
+	};
+
+	static_assert(std::is_trivially_copyable_v<entry_type>);
+
+public:
+	// Approximate number of stored tables
+	inline std::size_t size() const noexcept
+	{
+		return used_.load(std::memory_order_relaxed);
+	}
+
+	inline std::size_t capacity() const noexcept
+	{
+		return buckets_count_ * bucket_slots;
+	}
+
+	// Marks all stored tables as older than the ones stored from now on
+	inline void new_generation() noexcept
+	{
+		generation_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// Returns bounds of NS tricks; bounds are [0, max_tricks] for unknown tables.
+	template <typename TableType>
+	entry_type get_entry(bounds_type& bounds, const TableType& table)
+	{
+		const auto max_tricks {table.max_tricks()};
+		bounds = bounds_type {0, max_tricks};
+
+		if ((3 > max_tricks) || (!table.is_first_move()))
+		{
+			return entry_type {};
+		}
+
+		table_key key;
+		table.get_key(key);
+
+		const uint64_t hash {make_hash(key)};
+		const bool reverse {table.current_player().is_ns()};
+
+		uint64_t data {0};
+		if (nullptr != find(buckets_[hash & (buckets_count_ - 1)], hash, data))
+		{
+			bounds = unpack(data);
+			if (reverse)
+			{
+				bounds = bounds.reversed(max_tricks);
+			}
+			if (bounds.has_best_move())
+			{
+				bounds.set_best_move(key.table_move(bounds.best_move()));
+			}
+		}
+
+		return entry_type {this, hash, key, reverse, max_tricks};
+	}
+
+private:
+	struct slot
+	{
+		std::atomic<uint64_t> check_; // key ^ data_
+		std::atomic<uint64_t> data_;  // 0 for empty slot
+	};
+
+	struct alignas(64) bucket
+	{
+		slot slots_[bucket_slots];
+	};
+
+	// Data layout: bits 0..7 - lower bound, 8..15 - upper bound, 16..23 - best move,
+	// 24..31 - depth (tricks left), 32..39 - generation.
+	static inline uint64_t pack(const bounds_type& bounds, std::size_t depth, uint8_t generation) noexcept
+	{
+		const uint8_t best {bounds.has_best_move() ? static_cast<uint8_t>(bounds.best_move().index()) : bounds_type::no_move};
+		return static_cast<uint64_t>(bounds.lower()) | (static_cast<uint64_t>(bounds.upper()) << 8)
+			   | (static_cast<uint64_t>(best) << 16) | (static_cast<uint64_t>(depth) << 24)
+			   | (static_cast<uint64_t>(generation) << 32);
+	}
+
+	static inline bounds_type unpack(uint64_t data) noexcept
+	{
+		return bounds_type {data & 0xFF, (data >> 8) & 0xFF, static_cast<uint8_t>(data >> 16)};
+	}
+
+	static inline uint8_t data_depth(uint64_t data) noexcept
+	{
+		return static_cast<uint8_t>(data >> 24);
+	}
+
+	static inline uint8_t data_generation(uint64_t data) noexcept
+	{
+		return static_cast<uint8_t>(data >> 32);
+	}
+
+	static std::size_t buckets_for_budget(std::size_t memory_budget) noexcept
+	{
+		std::size_t res {1};
+		while ((res * 2 * sizeof(bucket)) <= memory_budget)
+		{
+			res *= 2;
+		}
+		return res;
+	}
+
+	// Hash of the stored table mixed with trump into one 64-bit key
+	static inline uint64_t make_hash(const table_key& key) noexcept
+	{
+		const uint64_t trump {static_cast<uint64_t>(static_cast<uint8_t>(key.trump())) + 1};
+		return mix(static_cast<uint64_t>(key.hash().hash()) ^ (trump * 0x9E3779B97F4A7C15ull));
+	}
+
+	// Finalizer of splitmix64
+	static inline uint64_t mix(uint64_t v) noexcept
+	{
+		v = (v ^ (v >> 30)) * 0xBF58476D1CE4E5B9ull;
+		v = (v ^ (v >> 27)) * 0x94D049BB133111EBull;
+		return v ^ (v >> 31);
+	}
+
+	static inline slot* find(bucket& b, uint64_t hash, uint64_t& data) noexcept
+	{
+		for (auto& s : b.slots_)
+		{
+			const uint64_t d {s.data_.load(std::memory_order_relaxed)};
+			if ((0 != d) && ((s.check_.load(std::memory_order_relaxed) ^ d) == hash))
+			{
+				data = d;
+				return &s;
+			}
+		}
+		return nullptr;
+	}
+
+	void store(uint64_t hash, std::size_t depth, const bounds_type& bounds)
+	{
+		const uint8_t current {generation_.load(std::memory_order_relaxed)};
+
+		auto& b {buckets_[hash & (buckets_count_ - 1)]};
+		uint64_t data {0};
+		slot* s {find(b, hash, data)};
+
+		bounds_type merged {0, depth};
+		if (nullptr != s)
+		{
+			merged = unpack(data);
+		}
+		else
+		{
+			s = &b.slots_[0];
+			for (auto& candidate : b.slots_)
+			{
+				const uint64_t d {candidate.data_.load(std::memory_order_relaxed)};
+				if (0 == d)
+				{
+					s = &candidate;
+					used_.fetch_add(1, std::memory_order_relaxed);
+					break;
+				}
+
+				// Prefer tables of older generations, then tables with less tricks left
+				const uint64_t sd {s->data_.load(std::memory_order_relaxed)};
+				const uint8_t age {static_cast<uint8_t>(current - data_generation(d))};
+				const uint8_t s_age {static_cast<uint8_t>(current - data_generation(sd))};
+				if ((age > s_age) || ((age == s_age) && (data_depth(d) < data_depth(sd))))
+				{
+					s = &candidate;
+				}
+			}
+		}
+
+		merged.merge(bounds);
+
+		const uint64_t new_data {pack(merged, depth, current)};
+		s->data_.store(new_data, std::memory_order_relaxed);
+		s->check_.store(hash ^ new_data, std::memory_order_relaxed);
+	}
+
+private:
+	const std::size_t buckets_count_;
+	std::unique_ptr<bucket[]> buckets_;
+	std::atomic<std::size_t> used_ {0};
+	std::atomic<uint8_t> generation_ {0};
+};
+
+#endif // TABLE_CACHE_LOCKFREE_HPP
@@ -4,10 +4,14 @@
 #include <cstdint>
 #include <cstring>
 
+#include <mutex>
+
 #include "moves.hpp"
+#include "null_mutex.hpp"
 #include "table_hash.hpp"
+#include "table_key.hpp"
 
-template<template<typename...> typename MapType>
+template<template<typename...> typename MapType, typename MutexType = null_mutex>
 class table_cache_memory
 {
 public:
@@ -30,14 +34,22 @@ public:
 		entry_type& operator=(entry_type&&) = default;
 		~entry_type() = default;
 
-		inline entry_type(moves_t* entry, bool reverse, std::size_t max_tricks) noexcept
+		inline entry_type(moves_t* entry, MutexType* mutex, const table_key& key, bool reverse,
+						  std::size_t max_tricks) noexcept
 			: entry_ {entry}
+			, mutex_ {mutex}
+			, key_ {key}
 			, max_tricks_ {max_tricks}
 			, reverse_ {reverse}
 		{
 		}
 
 	public:
+		inline bool valid() const noexcept
+		{
+			return (nullptr != entry_);
+		}
+
 		inline void update(const moves_t& moves)
 		{
 			if (nullptr == entry_)
@@ -45,30 +57,38 @@ public:
 				return;
 			}
 
-			if (reverse_)
-			{
-				for (auto it {moves.rbegin()}; moves.rend() != it; --it)
-				{
-					entry_->push_back(move_t {it->card(), it->suit(), max_tricks_ - it->tricks()});
-				}
-			}
-			else
-			{
-				(*entry_) = moves;
-			}
+			moves_t stored;
+			key_.to_stored(moves, stored, reverse_, max_tricks_);
+
+			// Entry may be already filled by concurrent processor reached the same table
+			std::lock_guard<MutexType> lock {*mutex_};
+			(*entry_) = stored;
 		}
 
 	private:
 		moves_t* entry_ {nullptr};
+		MutexType* mutex_ {nullptr};
+		table_key key_;
 		std::size_t max_tricks_ {0};
 		bool reverse_ {false};
 	};
 
 	static_assert(std::is_trivially_copyable_v<entry_type>);
 
+	// Stored moves of the table for every trump; value of the map
+	struct moves_block
+	{
+		moves_t moves_[5];
+		inline void clear() noexcept
+		{
+			std::memset(moves_, 0, sizeof(moves_));
+		}
+	};
+
 public:
 	inline std::size_t size() const
 	{
+		std::lock_guard<MutexType> lock {mutex_};
 		return cache_.size();
 	}
 
@@ -85,46 +105,26 @@ public:
 			return entry_type {};
 		}
 
-		typename TableType::hash_type hash;
-		table.get_hash(hash);
+		table_key key;
+		table.get_key(key);
 
-		const auto trump {table.trump()};
+		std::lock_guard<MutexType> lock {mutex_};
 
-		auto res {cache_.try_emplace(hash)};
+		auto res {cache_.try_emplace(key.hash())};
 		if (res.second)
 		{
 			res.first->second.clear();
 		}
-		moves_t* entry {&(res.first->second.moves_[trump])};
+		moves_t* entry {&(res.first->second.moves_[key.trump()])};
 
 		const bool reverse {current_player.is_ns()};
+		key.from_stored(*entry, moves, reverse, max_tricks);
 
-		if (reverse)
-		{
-			for (auto it {entry->rbegin()}; entry->rend() != it; --it)
-			{
-				moves.push_back(move_t {it->card(), it->suit(), max_tricks - it->tricks()});
-			}
-		}
-		else
-		{
-			moves = (*entry);
-		}
-
-		return entry_type {entry, reverse, max_tricks};
+		return entry_type {entry, &mutex_, key, reverse, max_tricks};
 	}
 
 private:
-	struct moves_block
-	{
-		moves_t moves_[5];
-		inline void clear() noexcept
-		{
-			std::memset(moves_, 0, sizeof(moves_));
-		}
-	};
-
-private:
+	mutable MutexType mutex_;
 	MapType<table_hash, moves_block> cache_;
 };
 
@@ -0,0 +1,100 @@
+#ifndef TABLE_CACHE_SHARDED_HPP
+#define TABLE_CACHE_SHARDED_HPP
+
+#include <cstdint>
+
+#include <mutex>
+
+#include "moves.hpp"
+#include "table_cache_memory.hpp"
+#include "table_hash.hpp"
+#include "table_key.hpp"
+
+/**
+ *****************************************************************************
+ * @brief The table_cache_sharded class - table_cache_memory split into
+ * Shards maps selected by table_hash::hash(), every map with its own mutex,
+ * so processors working in parallel rarely wait for each other.
+ */
+template <template <typename...> typename MapType, typename MutexType = std::mutex, std::size_t Shards = 64>
+class table_cache_sharded
+{
+	static_assert((0 != Shards) && (0 == (Shards & (Shards - 1))), "number of shards must be power of two");
+
+public:
+	using entry_type = typename table_cache_memory<MapType, MutexType>::entry_type;
+	using moves_block = typename table_cache_memory<MapType, MutexType>::moves_block;
+
+public:
+	table_cache_sharded() = default;
+	~table_cache_sharded() = default;
+
+	table_cache_sharded(const table_cache_sharded&) = delete;
+	table_cache_sharded(table_cache_sharded&&) = delete;
+	table_cache_sharded& operator=(const table_cache_sharded&) = delete;
+	table_cache_sharded& operator=(table_cache_sharded&&) = delete;
+
+public:
+	inline std::size_t size() const
+	{
+		std::size_t res {0};
+		for (const auto& s : shards_)
+		{
+			std::lock_guard<MutexType> lock {s.mutex_};
+			res += s.cache_.size();
+		}
+		return res;
+	}
+
+	// Maps keep all stored tables, so there are no generations to replace
+	inline void new_generation() noexcept
+	{
+	}
+
+	template <typename TableType>
+	entry_type get_entry(moves_t& moves, const TableType& table)
+	{
+		moves.clear();
+
+		const auto current_player {table.current_player()};
+		const auto max_tricks {table.max_tricks()};
+
+		if ((3 > max_tricks) || (!table.is_first_move()))
+		{
+			return entry_type {};
+		}
+
+		table_key key;
+		table.get_key(key);
+
+		// Maps hash their keys by the same function, so shard is selected by the high bits
+		const auto h {static_cast<uint64_t>(key.hash().hash())};
+		auto& s {shards_[(h >> 32) & (Shards - 1)]};
+
+		std::lock_guard<MutexType> lock {s.mutex_};
+
+		auto res {s.cache_.try_emplace(key.hash())};
+		if (res.second)
+		{
+			res.first->second.clear();
+		}
+		moves_t* entry {&(res.first->second.moves_[key.trump()])};
+
+		const bool reverse {current_player.is_ns()};
+		key.from_stored(*entry, moves, reverse, max_tricks);
+
+		return entry_type {entry, &s.mutex_, key, reverse, max_tricks};
+	}
+
+private:
+	struct alignas(64) shard
+	{
+		mutable MutexType mutex_;
+		MapType<table_hash, moves_block> cache_;
+	};
+
+private:
+	shard shards_[Shards];
+};
+
+#endif // TABLE_CACHE_SHARDED_HPP
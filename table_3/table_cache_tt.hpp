@@ -0,0 +1,221 @@
+#ifndef TABLE_CACHE_TT_HPP
+#define TABLE_CACHE_TT_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#include <memory>
+#include <mutex>
+
+#include "moves.hpp"
+#include "null_mutex.hpp"
+#include "table_hash.hpp"
+#include "table_key.hpp"
+
+/**
+ *****************************************************************************
+ * @brief The table_cache_tt class - fixed size transposition table with the
+ * same contract as table_cache_memory. Buckets of several cache line aligned
+ * slots are addressed by table_hash::hash(); when bucket is full, the slot of
+ * the oldest generation and then of the least depth (tricks left) is replaced.
+ */
+template <typename MutexType = null_mutex>
+class table_cache_tt
+{
+public:
+	static constexpr std::size_t bucket_slots {4};
+
+public:
+	explicit table_cache_tt(std::size_t memory_budget)
+		: buckets_count_ {buckets_for_budget(memory_budget)}
+		, buckets_ {new bucket[buckets_count_] {}}
+	{
+	}
+
+	~table_cache_tt() = default;
+
+	table_cache_tt(const table_cache_tt&) = delete;
+	table_cache_tt(table_cache_tt&&) = delete;
+	table_cache_tt& operator=(const table_cache_tt&) = delete;
+	table_cache_tt& operator=(table_cache_tt&&) = delete;
+
+public:
+	class entry_type
+	{
+	public:
+		entry_type() = default;
+		entry_type(const entry_type&) = default;
+		entry_type(entry_type&&) = default;
+		entry_type& operator=(const entry_type&) = default;
+		entry_type& operator=(entry_type&&) = default;
+		~entry_type() = default;
+
+		inline entry_type(table_cache_tt* cache, const table_key& key, bool reverse, std::size_t max_tricks) noexcept
+			: cache_ {cache}
+			, key_ {key}
+			, max_tricks_ {max_tricks}
+			, reverse_ {reverse}
+		{
+		}
+
+	public:
+		inline bool valid() const noexcept
+		{
+			return (nullptr != cache_);
+		}
+
+		inline void update(const moves_t& moves)
+		{
+			if (nullptr == cache_)
+			{
+				return;
+			}
+
+			moves_t stored;
+			key_.to_stored(moves, stored, reverse_, max_tricks_);
+			cache_->store(key_.hash(), key_.trump(), max_tricks_, stored);
+		}
+
+	private:
+		table_cache_tt* cache_ {nullptr};
+		table_key key_;
+		std::size_t max_tricks_ {0};
+		bool reverse_ {false};
+	};
+
+	static_assert(std::is_trivially_copyable_v<entry_type>);
+
+public:
+	inline std::size_t size() const
+	{
+		std::lock_guard<MutexType> lock {mutex_};
+		return used_;
+	}
+
+	inline std::size_t capacity() const noexcept
+	{
+		return buckets_count_ * bucket_slots;
+	}
+
+	// Marks all stored tables as older than the ones stored from now on
+	inline void new_generation() noexcept
+	{
+		std::lock_guard<MutexType> lock {mutex_};
+		++generation_;
+	}
+
+	template <typename TableType>
+	entry_type get_entry(moves_t& moves, const TableType& table)
+	{
+		moves.clear();
+
+		const auto current_player {table.current_player()};
+		const auto max_tricks {table.max_tricks()};
+
+		if ((3 > max_tricks) || (!table.is_first_move()))
+		{
+			return entry_type {};
+		}
+
+		table_key key;
+		table.get_key(key);
+
+		const bool reverse {current_player.is_ns()};
+
+		moves_t stored;
+		stored.clear();
+		{
+			std::lock_guard<MutexType> lock {mutex_};
+
+			const slot* s {find(buckets_[key.hash().hash() & (buckets_count_ - 1)], key.hash())};
+			if (nullptr != s)
+			{
+				stored = s->moves_[key.trump()];
+			}
+		}
+		key.from_stored(stored, moves, reverse, max_tricks);
+
+		return entry_type {this, key, reverse, max_tricks};
+	}
+
+private:
+	struct alignas(64) slot
+	{
+		table_hash hash_;
+		uint8_t depth_; // 0 for empty slot
+		uint8_t generation_;
+		moves_t moves_[5];
+	};
+
+	struct bucket
+	{
+		slot slots_[bucket_slots];
+	};
+
+	static std::size_t buckets_for_budget(std::size_t memory_budget) noexcept
+	{
+		std::size_t res {1};
+		while ((res * 2 * sizeof(bucket)) <= memory_budget)
+		{
+			res *= 2;
+		}
+		return res;
+	}
+
+	static inline slot* find(bucket& b, const table_hash& hash) noexcept
+	{
+		for (auto& s : b.slots_)
+		{
+			if ((0 != s.depth_) && (s.hash_ == hash))
+			{
+				return &s;
+			}
+		}
+		return nullptr;
+	}
+
+	void store(const table_hash& hash, suit_t trump, std::size_t depth, const moves_t& moves)
+	{
+		std::lock_guard<MutexType> lock {mutex_};
+
+		auto& b {buckets_[hash.hash() & (buckets_count_ - 1)]};
+		slot* s {find(b, hash)};
+		if (nullptr == s)
+		{
+			s = &b.slots_[0];
+			for (auto& candidate : b.slots_)
+			{
+				if (0 == candidate.depth_)
+				{
+					s = &candidate;
+					++used_;
+					break;
+				}
+
+				// Prefer tables of older generations, then tables with less tricks left
+				const uint8_t age {static_cast<uint8_t>(generation_ - candidate.generation_)};
+				const uint8_t s_age {static_cast<uint8_t>(generation_ - s->generation_)};
+				if ((age > s_age) || ((age == s_age) && (candidate.depth_ < s->depth_)))
+				{
+					s = &candidate;
+				}
+			}
+
+			std::memset(s->moves_, 0, sizeof(s->moves_));
+			s->hash_ = hash;
+			s->depth_ = static_cast<uint8_t>(depth);
+		}
+
+		s->generation_ = generation_;
+		s->moves_[trump] = moves;
+	}
+
+private:
+	const std::size_t buckets_count_;
+	std::unique_ptr<bucket[]> buckets_;
+	std::size_t used_ {0};
+	uint8_t generation_ {0};
+	mutable MutexType mutex_;
+};
+
+#endif // TABLE_CACHE_TT_HPP
@@ -6,6 +6,8 @@
 #include <iomanip>
 #include <stdexcept>
 
+#include "bits.hpp"
+
 namespace first
 {
 
@@ -63,26 +65,15 @@ bool cards_t::append(card_t c) noexcept
 
 std::size_t cards_t::size() const noexcept
 {
-	std::size_t res {0};
-	for (underlying_type c = cards_; 0 != c; c >>= 1)
-	{
-		if (0 != (c & 1))
-		{
-			++res;
-		}
-	}
-	return res;
+	return bits::count(cards_);
 }
 
 void cards_t::get_available_moves(moves_t& moves, const suit_t& suit) const
 {
-	for (const auto& c : card_t::all())
-	{
-		if (0 != (cards_ & c))
-		{
-			moves.push_back(::move_t {c, suit, 0});
-		}
-	}
+	const unsigned suit_offset {16 * static_cast<unsigned>(static_cast<uint8_t>(suit))};
+	bits::for_each(cards_, [&moves, suit_offset](unsigned rank) {
+		moves.push_back(::move_t::from_index(suit_offset + rank));
+	});
 }
 
 void hand_t::get_available_moves(moves_t& moves, const suit_t& suit) const
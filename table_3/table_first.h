@@ -16,6 +16,7 @@
 #include "enums.hpp"
 #include "moves.hpp"
 #include "table_hash.hpp"
+#include "table_key.hpp"
 
 namespace first
 {
@@ -90,6 +91,11 @@ public:
 		return cards_;
 	}
 
+	inline underlying_type bits() const noexcept
+	{
+		return cards_;
+	}
+
 	std::string to_string() const;
 	bool append(card_t c) noexcept;
 	std::size_t size() const noexcept;
@@ -120,12 +126,26 @@ public:
 	{
 	}
 
+	// Cards of the hand as 64-bit mask: 16 bits (card_t bits) per suit, clubs are the lowest ones
+	inline explicit hand_t(uint64_t cards) noexcept
+		: suites_ {cards_t {card_t {static_cast<uint16_t>(cards >> 0)}},
+				   cards_t {card_t {static_cast<uint16_t>(cards >> 16)}},
+				   cards_t {card_t {static_cast<uint16_t>(cards >> 32)}},
+				   cards_t {card_t {static_cast<uint16_t>(cards >> 48)}}}
+	{
+	}
+
 public:
 	inline cards_t& suit(suit_t s) noexcept
 	{
 		return suites_[s];
 	}
 
+	inline const cards_t& suit(suit_t s) const noexcept
+	{
+		return suites_[s];
+	}
+
 	inline bool empty() const noexcept
 	{
 		return suites_[0].empty()
@@ -197,6 +217,8 @@ public:
 
 public:
 	inline table_t()
+		: trump_ {suit_t::NoTrump}
+		, turn_starter_ {side_t::North}
 	{
 		moves_.clear();
 		update_table();
@@ -222,6 +244,16 @@ public:
 		update_table();
 	}
 
+	// Hands as 64-bit masks (see hand_t), used by readers of binary deal files
+	inline table_t(const uint64_t (&hands)[4], suit_t trump, side_t turn_starter, const moves_type& moves) noexcept
+		: hands_ {hand_t {hands[0]}, hand_t {hands[1]}, hand_t {hands[2]}, hand_t {hands[3]}}
+		, trump_ {trump}
+		, turn_starter_ {turn_starter}
+		, moves_ {moves}
+	{
+		update_table();
+	}
+
 public:
 	void dump(std::ostream& os = std::cout) const;
 	bool is_valid() const noexcept;
@@ -276,11 +308,69 @@ public:
 		return max_tricks_;
 	}
 
+	// Moves of the current player are equivalent, if there are no cards of other hands or of the
+	// current trick between them (cards played in previous tricks and own cards do not count).
+	inline bool is_equivalent(const move_t& m1, const move_t& m2) const noexcept
+	{
+		const suit_t s {m1.suit()};
+		if (m2.suit() != s)
+		{
+			return false;
+		}
+
+		uint16_t others {0};
+		for (const auto& side : side_t::all())
+		{
+			if (side != current_player_)
+			{
+				others |= hands_[side].suit(s).bits();
+			}
+		}
+		for (const auto& m : moves_)
+		{
+			if (m.suit() == s)
+			{
+				others |= static_cast<uint16_t>(m.card());
+			}
+		}
+
+		const uint16_t c1 {m1.card()};
+		const uint16_t c2 {m2.card()};
+		const uint16_t between {static_cast<uint16_t>((c1 < c2) ? (c2 - (c1 << 1)) : (c1 - (c2 << 1)))};
+		return (0 == (others & between));
+	}
+
 	inline const suit_t& trump() const noexcept
 	{
 		return trump_;
 	}
 
+	inline const side_t& turn_starter() const noexcept
+	{
+		return turn_starter_;
+	}
+
+	inline const moves_type& moves() const noexcept
+	{
+		return moves_;
+	}
+
+	inline std::size_t trick_size() const noexcept
+	{
+		return moves_.size();
+	}
+
+	inline const move_t& trick_move(std::size_t i) const noexcept
+	{
+		return moves_[i];
+	}
+
+	// Cards of the side in the suit as card_t bits
+	inline uint16_t suit_cards(const side_t& side, suit_t s) const noexcept
+	{
+		return hands_[side].suit(s).bits();
+	}
+
 	inline void set_starter(const side_t& s) noexcept
 	{
 		turn_starter_ = s;
@@ -330,6 +420,31 @@ public:
 		hands_[ts++].get_hash(&res[8 * 3]);
 	}
 
+	// Cards are stored in cache as they are (see simplify()); without trumps left
+	// the table is the same as in no trump.
+	inline void get_key(table_key& key) const noexcept
+	{
+		get_hash(key.hash());
+		key.set_trump(has_trumps() ? trump_ : suit_t {suit_t::NoTrump});
+	}
+
+	inline bool has_trumps() const noexcept
+	{
+		if (suit_t::NoTrump == trump_)
+		{
+			return false;
+		}
+
+		for (const auto& h : hands_)
+		{
+			if (!h.suit(trump_).empty())
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
 private:
 	inline void update_table() noexcept
 	{
@@ -13,6 +13,16 @@ struct table_hash
 		return data_[index];
 	}
 
+	inline const uint8_t* data() const noexcept
+	{
+		return data_;
+	}
+
+	static inline constexpr std::size_t size() noexcept
+	{
+		return sizeof(data_);
+	}
+
 	inline bool operator==(const table_hash& other) const noexcept
 	{
 		return (0 == std::memcmp(data_, other.data_, sizeof(data_)));
@@ -23,23 +33,20 @@ struct table_hash
 		return (0 > std::memcmp(data_, other.data_, sizeof(data_)));
 	}
 
-	inline size_t hash() const
+	// Multiply-xorshift mix of the four 64-bit words (one hand per word)
+	inline size_t hash() const noexcept
 	{
-		// computes the hash of an employee using a variant
-		// of the Fowler-Noll-Vo hash function
-		// from https://en.cppreference.com/w/cpp/utility/hash/operator()
-		size_t result {2166136261};
+		uint64_t words[4];
+		std::memcpy(words, data_, sizeof(words));
 
-		for (const auto c : data_)
+		uint64_t result {0x9E3779B97F4A7C15ull};
+		for (const auto w : words)
 		{
-			result = (result * 16777619) ^ c;
+			result = (result ^ w) * 0xBF58476D1CE4E5B9ull;
+			result ^= (result >> 31);
 		}
 
-		return result;
-
-		// const uint64_t* d {reinterpret_cast<const uint64_t*>(data_)};
-		// std::hash<uint64_t> h {};
-		// return h(d[0]) ^ h(d[1]) ^ h(d[2]) ^ h(d[3]);
+		return static_cast<size_t>(result);
 	}
 
 private:
@@ -0,0 +1,137 @@
+#ifndef TABLE_KEY_HPP
+#define TABLE_KEY_HPP
+
+#include <cstdint>
+
+#include "bits.hpp"
+#include "enums.hpp"
+#include "moves.hpp"
+#include "table_hash.hpp"
+
+/**
+ *****************************************************************************
+ * @brief The table_key class - cache key of the table: hash and trump of the
+ * table in the form it is stored in cache, and mapping of moves between the
+ * table and this form. Tables with canonical form (relative ranks, ordered
+ * suits) call set_mapping(); otherwise moves are stored as they are.
+ */
+class table_key
+{
+public:
+	table_key() = default;
+	table_key(const table_key&) = default;
+	table_key(table_key&&) = default;
+	table_key& operator=(const table_key&) = default;
+	table_key& operator=(table_key&&) = default;
+	~table_key() = default;
+
+public:
+	inline table_hash& hash() noexcept
+	{
+		return hash_;
+	}
+
+	inline const table_hash& hash() const noexcept
+	{
+		return hash_;
+	}
+
+	inline suit_t trump() const noexcept
+	{
+		return trump_;
+	}
+
+	inline void set_trump(suit_t trump) noexcept
+	{
+		trump_ = trump;
+	}
+
+	// Cards of canonical suit c are the remaining cards of table suit suits[c] (with relative ranks)
+	inline void set_mapping(const uint8_t (&suits)[4], const uint16_t (&cards)[4]) noexcept
+	{
+		for (uint8_t c = 0; c < 4; ++c)
+		{
+			table_suits_[c] = suits[c];
+			stored_suits_[suits[c]] = c;
+			cards_[c] = cards[c];
+		}
+		is_mapped_ = true;
+	}
+
+	inline move_t stored_move(const move_t& m) const noexcept
+	{
+		if (!is_mapped_)
+		{
+			return m;
+		}
+
+		const uint8_t c {stored_suits_[static_cast<uint8_t>(m.suit())]};
+		const auto below {static_cast<uint64_t>(cards_[c]) & ((static_cast<uint64_t>(1) << m.rank()) - 1)};
+		auto res {move_t::from_index(16 * c + bits::count(below))};
+		res.set_tricks(m.tricks());
+		return res;
+	}
+
+	inline move_t table_move(const move_t& m) const noexcept
+	{
+		if (!is_mapped_)
+		{
+			return m;
+		}
+
+		// Relative rank r is the r-th remaining card of the suit
+		uint64_t cards {cards_[m.suit()]};
+		for (unsigned r = m.rank(); 0 < r; --r)
+		{
+			cards &= (cards - 1);
+		}
+		auto res {move_t::from_index(16 * table_suits_[m.suit()] + bits::lowest(cards))};
+		res.set_tricks(m.tricks());
+		return res;
+	}
+
+	// Converts moves list between table and cache (in both directions): stored list is
+	// kept for the opponents of the turn starter, so it is reversed, when NS starts.
+	inline void to_stored(const moves_t& moves, moves_t& stored, bool reverse, std::size_t max_tricks) const noexcept
+	{
+		convert(moves, stored, reverse, max_tricks, &table_key::stored_move);
+	}
+
+	inline void from_stored(const moves_t& stored, moves_t& moves, bool reverse, std::size_t max_tricks) const noexcept
+	{
+		convert(stored, moves, reverse, max_tricks, &table_key::table_move);
+	}
+
+private:
+	inline void convert(const moves_t& src, moves_t& dst, bool reverse, std::size_t max_tricks,
+						move_t (table_key::*map)(const move_t&) const noexcept) const noexcept
+	{
+		dst.clear();
+		if (reverse)
+		{
+			for (auto it {src.rbegin()}; src.rend() != it; --it)
+			{
+				auto m {(this->*map)(*it)};
+				m.set_tricks(max_tricks - it->tricks());
+				dst.push_back(m);
+			}
+		}
+		else
+		{
+			for (const auto& m : src)
+			{
+				dst.push_back((this->*map)(m));
+			}
+		}
+	}
+
+private:
+	table_hash hash_;
+	suit_t trump_ {suit_t::NoTrump};
+	bool is_mapped_ {false};
+	uint8_t table_suits_[4] {};
+	uint8_t stored_suits_[4] {};
+	uint16_t cards_[4] {};
+};
+
+#endif // TABLE_KEY_HPP
@@ -3,14 +3,6 @@
 #include <iomanip>
 #include <iostream>
 
-void table_processor_base::out_iterations() const
-{
-	if (!m_suppress_output)
-	{
-		std::cout << std::setw(16) << m_iterations << std::string(16, '\b') << std::flush;
-	}
-}
-
 void table_processor_base::out_calculating_started(const std::string& message) const
 {
 	if (!m_suppress_output)
@@ -22,6 +14,11 @@ void table_processor_base::out_calculating_started(const std::string& message) c
 
 void table_processor_base::out_calculating_fineshed(std::chrono::microseconds::rep microseconds_passed) const
 {
+	if (nullptr != m_progress)
+	{
+		m_progress->detach(&m_iterations);
+	}
+
 	if (!m_suppress_output)
 	{
 		double ips {static_cast<double>(iterations()) / static_cast<double>(microseconds_passed)};
@@ -29,6 +26,7 @@ void table_processor_base::out_calculating_fineshed(std::chrono::microseconds::r
 				  << m_iterations << " it; "
 				  << m_simplified << " simp; "
 				  << m_skipped << " sk; "
+				  << m_cutoffs << " cut; "
 				  << ips << " Mips)" << std::endl;
 	}
 }
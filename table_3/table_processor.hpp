@@ -5,10 +5,117 @@
 
 #include <algorithm>
 #include <chrono>
+#include <deque>
 #include <map>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include "enums.hpp"
+#include "progress.hpp"
+#include "thread_pool.hpp"
+
+template <typename TableType, typename = void>
+struct has_undo_move : std::false_type
+{
+};
+
+template <typename TableType>
+struct has_undo_move<TableType, std::void_t<decltype(std::declval<TableType&>().undo_move())>> : std::true_type
+{
+};
+
+template <typename TableType>
+inline constexpr bool has_undo_move_v = has_undo_move<TableType>::value;
+
+template <typename TableType, typename = void>
+struct has_quick_tricks : std::false_type
+{
+};
+
+template <typename TableType>
+struct has_quick_tricks<TableType, std::void_t<decltype(std::declval<const TableType&>().quick_tricks()),
+											   decltype(std::declval<const TableType&>().sure_losers())>>
+	: std::true_type
+{
+};
+
+template <typename TableType>
+inline constexpr bool has_quick_tricks_v = has_quick_tricks<TableType>::value;
+
+/**
+ *****************************************************************************
+ * @brief The next_table class - table after the move. Tables supporting
+ * undo_move() are changed in place and restored on destruction, other
+ * tables are copied.
+ */
+template <typename TableType, bool InPlace = has_undo_move_v<TableType>>
+class next_table
+{
+public:
+	inline next_table(TableType& t, const typename TableType::move_type& m)
+		: table_ {t}
+		, winer_ {table_.make_move(m)}
+	{
+	}
+
+	inline ~next_table()
+	{
+		table_.undo_move();
+	}
+
+	next_table(const next_table&) = delete;
+	next_table(next_table&&) = delete;
+	next_table& operator=(const next_table&) = delete;
+	next_table& operator=(next_table&&) = delete;
+
+	inline TableType& table() noexcept
+	{
+		return table_;
+	}
+
+	// Winner side, if turn is finished, and turn starter otherwise.
+	inline side_t winer() const noexcept
+	{
+		return winer_;
+	}
+
+private:
+	TableType& table_;
+	side_t winer_;
+};
+
+template <typename TableType>
+class next_table<TableType, false>
+{
+public:
+	inline next_table(const TableType& t, const typename TableType::move_type& m)
+		: table_ {t}
+		, winer_ {table_.make_move(m)}
+	{
+	}
+
+	~next_table() = default;
+
+	next_table(const next_table&) = delete;
+	next_table(next_table&&) = delete;
+	next_table& operator=(const next_table&) = delete;
+	next_table& operator=(next_table&&) = delete;
+
+	inline TableType& table() noexcept
+	{
+		return table_;
+	}
+
+	inline side_t winer() const noexcept
+	{
+		return winer_;
+	}
+
+private:
+	TableType table_;
+	side_t winer_;
+};
 
 class table_processor_base
 {
@@ -20,11 +127,26 @@ public:
 	{
 	}
 
-	inline auto iterations() const noexcept
+	// Calculation left by an exception does not detach its counter, the sampler must not read it afterwards
+	inline ~table_processor_base()
+	{
+		if (nullptr != m_progress)
+		{
+			m_progress->detach(&m_iterations);
+		}
+	}
+
+	table_processor_base(const table_processor_base&) = default;
+	table_processor_base(table_processor_base&&) = default;
+	table_processor_base& operator=(const table_processor_base&) = default;
+	table_processor_base& operator=(table_processor_base&&) = default;
+
+	inline uint64_t iterations() const noexcept
 	{
 		return m_iterations;
 	}
 
+	// Incremented for every searched node; progress is printed by the sampler (see set_progress())
 	inline auto& iterations() noexcept
 	{
 		return m_iterations;
@@ -60,17 +182,55 @@ public:
 		return m_simplified;
 	}
 
+	inline auto cutoffs() const noexcept
+	{
+		return m_cutoffs;
+	}
+
+	inline auto& cutoffs() noexcept
+	{
+		return m_cutoffs;
+	}
+
 	inline void restart_processing(const std::string& message) noexcept
 	{
 		m_iterations = 0;
 		m_reused = 0;
 		m_skipped = 0;
 		m_simplified = 0;
+		m_cutoffs = 0;
 		out_calculating_started(message);
+		if ((nullptr != m_progress) && !m_suppress_output)
+		{
+			m_progress->attach(&m_iterations);
+		}
+	}
+
+	// Iterations of the calculations started by restart_processing() are printed by the sampler
+	inline void set_progress(progress_sampler* progress) noexcept
+	{
+		m_progress = progress;
+	}
+
+	inline void take_statistics(const table_processor_base& other) noexcept
+	{
+		m_iterations = other.m_iterations;
+		m_reused = other.m_reused;
+		m_skipped = other.m_skipped;
+		m_simplified = other.m_simplified;
+		m_cutoffs = other.m_cutoffs;
+	}
+
+	inline void add_statistics(const table_processor_base& other) noexcept
+	{
+		m_iterations += other.m_iterations;
+		m_reused += other.m_reused;
+		m_skipped += other.m_skipped;
+		m_simplified += other.m_simplified;
+		m_cutoffs += other.m_cutoffs;
 	}
 
 	void out_calculating_started(const std::string& message) const;
-	void out_iterations() const;
 	void out_calculating_fineshed(std::chrono::microseconds::rep microseconds_passed) const;
 
 	template <class Rep, class Period>
@@ -82,39 +242,265 @@ public:
 
 private:
 	bool m_suppress_output {false};
-	uint64_t m_iterations {0};
+	progress_sampler* m_progress {nullptr};
+	sampled_counter m_iterations {0};
 	uint64_t m_reused {0};
 	uint64_t m_skipped {0};
 	uint64_t m_simplified {0};
+	uint64_t m_cutoffs {0};
+};
+
+/**
+ *****************************************************************************
+ * @brief The table_processor_full class - calculation of the whole table
+ * (all starters and trumps) on top of Derived::process_table(). Optionally
+ * moves of the first plies of a single calculation are searched by tasks of
+ * the pool (root split); Derived::search_tricks() gives exact NS tricks of
+ * the table and the cache shared by the tasks keeps exact values only, so
+ * results are the same as of the serial search.
+ */
+template <typename Derived, typename TableType>
+class table_processor_full : public table_processor_base
+{
+public:
+	using table_type = TableType;
+	using result_type = std::map<side_t, std::map<suit_t, uint8_t>>;
+
+public:
+	using table_processor_base::table_processor_base;
+
+	inline result_type process_table_full(table_type table)
+	{
+		using namespace std::chrono;
+
+		result_type result;
+
+		total_iterations_ = 0;
+		auto start {steady_clock::now()};
+
+		for (const auto& side : side_t::all())
+		{
+			table.set_starter(side + 1);
+			for (const auto& trump : suit_t::all())
+			{
+				table.set_trump(trump);
+				result[side][trump] = self().process_table(table);
+				total_iterations_ += iterations();
+			}
+		}
+
+		total_duration_ = duration_cast<microseconds>(steady_clock::now() - start).count();
+
+		return result;
+	}
+
+	// Runs all (starter, trump) calculations as tasks of the pool; cache must be thread-safe.
+	inline result_type process_table_full(const table_type& table, thread_pool& pool)
+	{
+		using namespace std::chrono;
+
+		struct task_state
+		{
+			side_t side_;
+			suit_t trump_;
+			table_type table_;
+			Derived processor_;
+			uint8_t tricks_;
+			steady_clock::duration duration_;
+		};
+
+		std::deque<task_state> tasks;
+		thread_pool::group group;
+
+		total_iterations_ = 0;
+		auto start {steady_clock::now()};
+
+		for (const auto& side : side_t::all())
+		{
+			for (const auto& trump : suit_t::all())
+			{
+				auto& task {tasks.emplace_back(task_state {side, trump, table, self().worker(), 0, {}})};
+				task.processor_.set_root_split(split_pool_, split_depth_);
+				task.table_.set_starter(side + 1);
+				task.table_.set_trump(trump);
+				pool.submit(group, [&task]() {
+					auto task_start {steady_clock::now()};
+					task.tricks_ = task.processor_.process_table(task.table_);
+					task.duration_ = steady_clock::now() - task_start;
+				});
+			}
+		}
+
+		pool.wait(group);
+
+		total_duration_ = duration_cast<microseconds>(steady_clock::now() - start).count();
+
+		result_type result;
+		for (const auto& task : tasks)
+		{
+			out_calculating_started(std::string {"["} + task.side_.to_string() + ", " + task.trump_.to_string() + "]");
+			take_statistics(task.processor_);
+			out_calculating_fineshed(task.duration_);
+
+			result[task.side_][task.trump_] = task.tricks_;
+			total_iterations_ += iterations();
+		}
+
+		return result;
+	}
+
+	inline auto total_iterations() const noexcept
+	{
+		return total_iterations_;
+	}
+
+	// Called before the calculations of the next deal; Derived drops state learnt on the previous one
+	inline void new_deal() noexcept
+	{
+	}
+
+	// Moves of the first depth plies of every process_table() are searched by tasks of the pool
+	// (sharing the cache, which must be thread-safe); 0 or no pool means serial search.
+	inline void set_root_split(thread_pool* pool, std::size_t depth) noexcept
+	{
+		split_pool_ = pool;
+		split_depth_ = (nullptr != pool) ? depth : 0;
+	}
+
+	inline bool is_root_split() const noexcept
+	{
+		return (0 != split_depth_);
+	}
+
+	inline auto total_duration() const noexcept
+	{
+		return total_duration_;
+	}
+
+protected:
+	// Exact NS tricks of the table with root split; values of the moves are returned in res_moves.
+	inline std::size_t split_tricks(table_type& t, typename table_type::moves_type* res_moves = nullptr)
+	{
+		return split_tricks(t, split_depth_, res_moves);
+	}
+
+private:
+	inline Derived& self() noexcept
+	{
+		return static_cast<Derived&>(*this);
+	}
+
+	inline std::size_t split_tricks(table_type& t, std::size_t depth, typename table_type::moves_type* res_moves)
+	{
+		using move_type = typename table_type::move_type;
+
+		struct split_task
+		{
+			move_type move_;
+			table_type table_;
+			Derived processor_;
+		};
+
+		typename table_type::moves_type moves {};
+		t.get_available_moves(moves);
+		assert(!moves.empty());
+
+		const bool is_last_move {t.is_last_move()};
+
+		std::deque<split_task> tasks;
+		thread_pool::group group;
+
+		for (std::size_t i = 0; i < moves.size(); ++i)
+		{
+			if ((0 < i) && t.is_equivalent(moves[i - 1], moves[i]))
+			{
+				++this->skipped();
+				continue;
+			}
+
+			auto& task {tasks.emplace_back(split_task {moves[i], t, self().worker()})};
+			split_pool_->submit(group, [&task, depth, is_last_move, this]() {
+				next_table<table_type> nt {task.table_, task.move_};
+
+				std::size_t tricks {(is_last_move && nt.winer().is_ns()) ? 1u : 0u};
+				if (!nt.table().empty())
+				{
+					if (1 < depth)
+					{
+						task.processor_.set_root_split(split_pool_, depth - 1);
+						tricks += task.processor_.split_tricks(nt.table(), depth - 1, nullptr);
+					}
+					else
+					{
+						tricks += task.processor_.search_tricks(nt.table());
+					}
+				}
+				task.move_.set_tricks(tricks);
+			});
+		}
+
+		split_pool_->wait(group);
+
+		// Equivalent moves take the value of their neighbors
+		auto task {tasks.cbegin()};
+		for (std::size_t i = 0; i < moves.size(); ++i)
+		{
+			if ((0 < i) && t.is_equivalent(moves[i - 1], moves[i]))
+			{
+				moves[i].set_tricks(moves[i - 1].tricks());
+			}
+			else
+			{
+				moves[i].set_tricks(task->move_.tricks());
+				this->add_statistics(task->processor_);
+				++task;
+			}
+		}
+
+		std::sort(moves.begin(), moves.end());
+		if (nullptr != res_moves)
+		{
+			*res_moves = moves;
+		}
+
+		return t.current_player().is_ns() ? moves.back().tricks() : moves.front().tricks();
+	}
+
+private:
+	uint64_t total_iterations_ {0};
+	uint64_t total_duration_ {0};
+	thread_pool* split_pool_ {nullptr};
+	std::size_t split_depth_ {0};
 };
 
 template <typename TableType, typename CacheType, bool UseSimplify>
-class table_processor : public table_processor_base
+class table_processor : public table_processor_full<table_processor<TableType, CacheType, UseSimplify>, TableType>
 {
 public:
 	using table_type = TableType;
 	using move_type = typename table_type::move_type;
 	using moves_type = typename table_type::moves_type;
-	using result_type = std::map<side_t, std::map<suit_t, uint8_t>>;
+	using result_type = typename table_processor::result_type;
 	using cache_type = CacheType;
 
+	static_assert(!(UseSimplify && has_undo_move_v<TableType>),
+				  "simplify() changes cards in place and can not be combined with undo_move()");
+
 public:
 	inline table_processor(cache_type& tc, bool suppress_output = false) noexcept
-		: table_processor_base {suppress_output}
+		: table_processor::table_processor_full {suppress_output}
 		, tc_ {tc}
 	{
 	}
 
 private:
-	inline move_type process_table_internal(table_type& t, std::size_t max_ns_found, std::size_t max_ew_found,
-											moves_type* res_moves = nullptr)
+	// Values of all moves are exact (nothing is cut off by the values of other branches), so they can be
+	// stored into the cache and reused by any search reaching the same table.
+	inline move_type process_table_internal(table_type& t, moves_type* res_moves = nullptr)
 	{
 		assert(!t.empty());
 
-		if (0 == ((++iterations()) % 1000000))
-		{
-			out_iterations();
-		}
+		++this->iterations();
 
 		const bool is_last_move {t.is_last_move()};
 		const bool is_ns {t.current_player().is_ns()};
@@ -125,7 +511,7 @@ private:
 			uint64_t simplify_mask {0};
 			if ((2 < max_tricks) && t.is_first_move() && (0 != (simplify_mask = t.simplify())))
 			{
-				++simplified();
+				++this->simplified();
 			}
 		}
 
@@ -134,7 +520,7 @@ private:
 
 		if (!moves.empty())
 		{
-			++reused();
+			++this->reused();
 		}
 		else
 		{
@@ -143,59 +529,24 @@ private:
 
 			for (std::size_t i = 0; i < moves.size(); ++i)
 			{
-				assert(max_ns_found <= max_tricks);
-				assert(max_ew_found <= max_tricks);
-
 				auto& m {moves[i]};
-				if ((0 < i) && m.is_neighbor(moves[i - 1]))
+				if ((0 < i) && t.is_equivalent(moves[i - 1], m))
 				{
 					m.set_tricks(moves[i - 1].tricks());
-					++skipped();
+					++this->skipped();
 					continue;
 				}
 
-				table_type nt {t};
-				side_t winer {nt.make_move(m)};
+				next_table<table_type> nt {t, m};
 
-				if (is_last_move)
+				if (is_last_move && nt.winer().is_ns())
 				{
-					if (winer.is_ns())
-					{
-						if (max_ew_found >= max_tricks)
-						{
-							m.set_tricks(max_tricks);
-							continue;
-						}
-
-						m.add_tricks(1);
-						max_ns_found = (0 < max_ns_found) ? (max_ns_found - 1) : 0;
-					}
-					else
-					{
-						if (max_ns_found >= max_tricks)
-						{
-							continue;
-						}
-
-						max_ew_found = (0 < max_ew_found) ? (max_ew_found - 1) : 0;
-					}
+					m.add_tricks(1);
 				}
 
-				if (!nt.empty())
+				if (!nt.table().empty())
 				{
-					m.add_tricks(process_table_internal(nt, max_ns_found, max_ew_found).tricks());
-					if (is_last_move)
-					{
-						if (is_ns)
-						{
-							max_ns_found = std::max<std::size_t>(max_ns_found, m.tricks());
-						}
-						else
-						{
-							assert(max_tricks >= m.tricks());
-							max_ew_found = std::max<std::size_t>(max_ew_found, max_tricks - m.tricks());
-						}
-					}
+					m.add_tricks(process_table_internal(nt.table()).tricks());
 				}
 			}
 
@@ -214,55 +565,36 @@ private:
 public:
 	uint8_t process_table(table_type& table, moves_type* res_moves = nullptr)
 	{
-		restart_processing(std::string {"["} + (table.current_player() - 1).to_string()
-						   + ", " + table.trump().to_string() + "]");
+		this->restart_processing(std::string {"["} + (table.current_player() - 1).to_string()
+								 + ", " + table.trump().to_string() + "]");
 
 		auto start {std::chrono::steady_clock::now()};
-		auto res {process_table_internal(table, 0, 0, res_moves)};
-		out_calculating_fineshed(std::chrono::steady_clock::now() - start);
+		const std::size_t res {this->is_root_split() ? this->split_tricks(table, res_moves)
+													 : process_table_internal(table, res_moves).tricks()};
+		this->out_calculating_fineshed(std::chrono::steady_clock::now() - start);
 
-		return res.tricks();
+		return static_cast<uint8_t>(res);
 	}
 
-	inline result_type process_table_full(table_type table)
+	// Exact number of NS tricks from the current trick on (used by root split)
+	inline std::size_t search_tricks(table_type& t)
 	{
-		using namespace std::chrono;
-
-		result_type result;
-
-		total_iterations_ = 0;
-		auto start {steady_clock::now()};
-
-		for (const auto& side : side_t::all())
-		{
-			table.set_starter(side + 1);
-			for (const auto& trump : suit_t::all())
-			{
-				table.set_trump(trump);
-				result[side][trump] = process_table(table);
-				total_iterations_ += iterations();
-			}
-		}
-
-		total_duration_ = duration_cast<microseconds>(steady_clock::now() - start).count();
-
-		return result;
+		return process_table_internal(t).tricks();
 	}
 
-	inline auto total_iterations() const noexcept
+	inline std::size_t cache_size() const
 	{
-		return total_iterations_;
+		return tc_.size();
 	}
 
-	inline auto total_duration() const noexcept
+	// Processor sharing the same cache, used by parallel calculations
+	inline table_processor worker() const noexcept
 	{
-		return total_duration_;
+		return table_processor {tc_, true};
 	}
 
 private:
 	cache_type& tc_;
-	uint64_t total_iterations_ {0};
-	uint64_t total_duration_ {0};
 };
 
 #endif // TABLE_PROCESSOR_HPP
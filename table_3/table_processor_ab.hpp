@@ -0,0 +1,369 @@
+#ifndef TABLE_PROCESSOR_AB_HPP
+#define TABLE_PROCESSOR_AB_HPP
+
+#include <cassert>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <string>
+
+#include "enums.hpp"
+#include "move_ordering.hpp"
+#include "table_processor.hpp"
+
+/**
+ *****************************************************************************
+ * @brief The table_processor_ab class - bounded window search: every
+ * calculation is a set of null-window tests "can NS take at least k tricks?"
+ * with binary search over k. Each test stops at the first move deciding it.
+ * Results of the tests are kept in the cache as bounds of tricks (see
+ * table_cache_bounds) together with the move deciding the test.
+ *
+ * Optionally the tests are searched in parallel (Young Brothers Wait): at the
+ * first plies of the calculation the first move is searched serially, and
+ * only when it does not decide the test, the remaining moves are searched by
+ * tasks of the pool. The first task deciding the test cancels its siblings.
+ */
+template <typename TableType, typename CacheType>
+class table_processor_ab : public table_processor_full<table_processor_ab<TableType, CacheType>, TableType>
+{
+public:
+	using table_type = TableType;
+	using move_type = typename table_type::move_type;
+	using moves_type = typename table_type::moves_type;
+	using result_type = typename table_processor_ab::result_type;
+	using cache_type = CacheType;
+	using bounds_type = typename cache_type::bounds_type;
+
+public:
+	inline explicit table_processor_ab(cache_type& tc, move_ordering_t ordering = move_ordering_t::heuristic,
+									   bool suppress_output = false) noexcept
+		: table_processor_ab::table_processor_full {suppress_output}
+		, tc_ {tc}
+		, orderer_ {ordering}
+	{
+	}
+
+	// Moves of nodes at the first plies of every test are searched in parallel by tasks of the pool
+	// (sharing the cache, which must be thread-safe); 0 or no pool means serial search.
+	inline void set_parallel_plies(thread_pool* pool, std::size_t plies) noexcept
+	{
+		ybwc_pool_ = pool;
+		ybwc_plies_ = (nullptr != pool) ? plies : 0;
+	}
+
+private:
+	// Stop flag of the parallel node and flags of its parallel ancestors
+	struct cancel_token
+	{
+		std::atomic<bool> stop_ {false};
+		const cancel_token* parent_ {nullptr};
+
+		inline bool cancelled() const noexcept
+		{
+			for (const cancel_token* c = this; nullptr != c; c = c->parent_)
+			{
+				if (c->stop_.load(std::memory_order_relaxed))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+	};
+
+	// Results of cancelled searches are meaningless, they are neither used nor saved in cache
+	inline bool is_cancelled() const noexcept
+	{
+		return (nullptr != cancel_) && cancel_->cancelled();
+	}
+
+	// Returns true if NS can take at least target tricks from the current trick on.
+	inline bool is_ns_making(table_type& t, std::size_t target, std::size_t ply = 0)
+	{
+		assert(!t.empty());
+
+		if (is_cancelled())
+		{
+			return false;
+		}
+
+		++this->iterations();
+
+		if (0 == target)
+		{
+			return true;
+		}
+
+		if (target > t.max_tricks())
+		{
+			return false;
+		}
+
+		const bool is_last_move {t.is_last_move()};
+		const bool is_ns {t.current_player().is_ns()};
+
+		if constexpr (has_quick_tricks_v<table_type>)
+		{
+			if (t.is_first_move())
+			{
+				// Bounds for the starter side decide the test without search
+				const std::size_t own_min {t.quick_tricks()};
+				const std::size_t opp_min {t.sure_losers()};
+				const std::size_t ns_min {is_ns ? own_min : opp_min};
+				const std::size_t ns_max {t.max_tricks() - (is_ns ? opp_min : own_min)};
+				if ((ns_min >= target) || (ns_max < target))
+				{
+					++this->cutoffs();
+					return (ns_min >= target);
+				}
+			}
+		}
+
+		bounds_type bounds {};
+		auto cache_entry {tc_.get_entry(bounds, t)};
+		if ((bounds.lower() >= target) || (bounds.upper() < target))
+		{
+			++this->reused();
+			return (bounds.lower() >= target);
+		}
+
+		moves_type available {};
+		t.get_available_moves(available);
+		assert(!available.empty());
+
+		// Equivalent moves are dropped before ordering, while they are still neighbors
+		moves_type moves {};
+		for (std::size_t i = 0; i < available.size(); ++i)
+		{
+			if ((0 < i) && t.is_equivalent(available[i - 1], available[i]))
+			{
+				++this->skipped();
+				continue;
+			}
+			moves.push_back(available[i]);
+		}
+
+		orderer_.order(t, moves);
+		if (bounds.has_best_move())
+		{
+			move_to_front(moves, bounds.best_move());
+		}
+
+		for (std::size_t i = 0; i < moves.size(); ++i)
+		{
+			if ((0 < i) && (ply < ybwc_plies_))
+			{
+				return is_ns_making_parallel(t, target, ply, moves, i, cache_entry);
+			}
+
+			const auto& m {moves[i]};
+			bool making {false};
+			{
+				next_table<table_type> nt {t, m};
+
+				const std::size_t next_target {(is_last_move && nt.winer().is_ns()) ? (target - 1) : target};
+				making = nt.table().empty() ? (0 == next_target) : is_ns_making(nt.table(), next_target, ply + 1);
+			}
+
+			if (is_cancelled())
+			{
+				return false;
+			}
+
+			// NS needs one move reaching the target, EW needs one move preventing it
+			if (making == is_ns)
+			{
+				orderer_.cutoff(t, m);
+				cache_entry.update(making ? bounds_type {target, t.max_tricks(), static_cast<uint8_t>(m.index())}
+										  : bounds_type {0, target - 1, static_cast<uint8_t>(m.index())});
+				return making;
+			}
+		}
+
+		cache_entry.update(is_ns ? bounds_type {0, target - 1} : bounds_type {target, t.max_tricks()});
+		return !is_ns;
+	}
+
+	// Searches moves starting from the first one by tasks of the pool (the elder brother is searched already)
+	bool is_ns_making_parallel(table_type& t, std::size_t target, std::size_t ply, const moves_type& moves,
+							   std::size_t first, typename cache_type::entry_type& cache_entry)
+	{
+		struct sibling_task
+		{
+			move_type move_;
+			table_type table_;
+			table_processor_ab processor_;
+			bool done_;
+			bool making_;
+		};
+
+		const bool is_last_move {t.is_last_move()};
+		const bool is_ns {t.current_player().is_ns()};
+
+		cancel_token token {};
+		token.parent_ = cancel_;
+
+		std::deque<sibling_task> tasks;
+		thread_pool::group group;
+
+		for (std::size_t i = first; i < moves.size(); ++i)
+		{
+			auto& task {tasks.emplace_back(sibling_task {moves[i], t, worker(), false, false})};
+			task.processor_.orderer_ = orderer_;
+			task.processor_.cancel_ = &token;
+			ybwc_pool_->submit(group, [&task, &token, target, ply, is_last_move, is_ns]() {
+				if (token.cancelled())
+				{
+					return;
+				}
+
+				bool making {false};
+				{
+					next_table<table_type> nt {task.table_, task.move_};
+
+					const std::size_t next_target {(is_last_move && nt.winer().is_ns()) ? (target - 1) : target};
+					making = nt.table().empty() ? (0 == next_target)
+												: task.processor_.is_ns_making(nt.table(), next_target, ply + 1);
+				}
+
+				// Search interrupted by the cancellation has no result
+				if (!token.cancelled())
+				{
+					task.making_ = making;
+					task.done_ = true;
+					if (making == is_ns)
+					{
+						token.stop_.store(true, std::memory_order_relaxed);
+					}
+				}
+			});
+		}
+
+		ybwc_pool_->wait(group);
+
+		for (const auto& task : tasks)
+		{
+			this->add_statistics(task.processor_);
+		}
+
+		if (is_cancelled())
+		{
+			return false;
+		}
+
+		for (const auto& task : tasks)
+		{
+			if (task.done_ && (task.making_ == is_ns))
+			{
+				orderer_.cutoff(t, task.move_);
+				cache_entry.update(is_ns ? bounds_type {target, t.max_tricks(), static_cast<uint8_t>(task.move_.index())}
+										 : bounds_type {0, target - 1, static_cast<uint8_t>(task.move_.index())});
+				return is_ns;
+			}
+		}
+
+		cache_entry.update(is_ns ? bounds_type {0, target - 1} : bounds_type {target, t.max_tricks()});
+		return !is_ns;
+	}
+
+	static inline void move_to_front(moves_type& moves, const move_type& m) noexcept
+	{
+		const auto it {std::find_if(moves.begin(), moves.end(), [&m](const move_type& other) {
+			return other.index() == m.index();
+		})};
+		if (moves.end() != it)
+		{
+			std::rotate(moves.begin(), it, it + 1);
+		}
+	}
+
+public:
+	uint8_t process_table(table_type& table, moves_type* res_moves = nullptr)
+	{
+		this->restart_processing(std::string {"["} + (table.current_player() - 1).to_string()
+								 + ", " + table.trump().to_string() + "]");
+
+		auto start {std::chrono::steady_clock::now()};
+
+		std::size_t res {0};
+		if (this->is_root_split())
+		{
+			res = this->split_tricks(table, res_moves);
+		}
+		else if (nullptr == res_moves)
+		{
+			res = search_tricks(table);
+		}
+		else
+		{
+			// Exact value of every move is requested, so each of them is searched separately
+			const bool is_last_move {table.is_last_move()};
+			table.get_available_moves(*res_moves);
+			for (auto& m : *res_moves)
+			{
+				next_table<table_type> nt {table, m};
+				m.set_tricks(((is_last_move && nt.winer().is_ns()) ? 1 : 0)
+							 + (nt.table().empty() ? 0 : search_tricks(nt.table())));
+			}
+
+			std::sort(res_moves->begin(), res_moves->end());
+			res = table.current_player().is_ns() ? res_moves->back().tricks() : res_moves->front().tricks();
+		}
+
+		this->out_calculating_fineshed(std::chrono::steady_clock::now() - start);
+
+		return static_cast<uint8_t>(res);
+	}
+
+	// Returns exact number of NS tricks from the current trick on (also used by root split).
+	inline std::size_t search_tricks(table_type& t)
+	{
+		std::size_t lower {0};
+		std::size_t upper {t.max_tricks()};
+
+		while (lower < upper)
+		{
+			const std::size_t target {(lower + upper + 1) / 2};
+			if (is_ns_making(t, target))
+			{
+				lower = target;
+			}
+			else
+			{
+				upper = target - 1;
+			}
+		}
+
+		return lower;
+	}
+
+	inline std::size_t cache_size() const
+	{
+		return tc_.size();
+	}
+
+	inline void new_deal() noexcept
+	{
+		orderer_.new_deal();
+	}
+
+	// Processor sharing the same cache, used by parallel calculations
+	inline table_processor_ab worker() const noexcept
+	{
+		table_processor_ab res {tc_, orderer_.ordering(), true};
+		res.set_parallel_plies(ybwc_pool_, ybwc_plies_);
+		return res;
+	}
+
+private:
+	cache_type& tc_;
+	move_orderer<table_type> orderer_;
+	thread_pool* ybwc_pool_ {nullptr};
+	std::size_t ybwc_plies_ {0};
+	const cancel_token* cancel_ {nullptr};
+};
+
+#endif // TABLE_PROCESSOR_AB_HPP
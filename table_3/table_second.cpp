@@ -0,0 +1,331 @@
+#include "table_second.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+#include <utility>
+
+#include "bits.hpp"
+
+namespace second
+{
+
+table_t::table_t(const first::table_t& t)
+	: trump_ {t.trump()}
+	, trick_index_ {0}
+	, trick_size_ {0}
+	, tricks_left_ {0}
+{
+	for (const auto& side : side_t::all())
+	{
+		hands_[side] = 0;
+		for (std::size_t i = 0; i < 4; ++i)
+		{
+			hands_[side] |= static_cast<uint64_t>(t.hand(side).suit(suit_t {i}).bits()) << (16 * i);
+		}
+	}
+
+	tricks_[0].starter_ = t.turn_starter();
+	for (const auto& m : t.moves())
+	{
+		tricks_[0].moves_[trick_size_++] = m;
+	}
+
+	tricks_left_ = static_cast<uint8_t>(cards_count(hands_[current_player()]));
+}
+
+std::size_t table_t::cards_count(uint64_t cards) noexcept
+{
+	return bits::count(cards);
+}
+
+uint64_t table_t::top_cards(uint64_t cards, uint64_t others) noexcept
+{
+	if (0 == others)
+	{
+		return cards;
+	}
+	return cards & ~((static_cast<uint64_t>(2) << bits::highest(others)) - 1);
+}
+
+std::size_t table_t::quick_tricks() const noexcept
+{
+	const side_t starter {tricks_[trick_index_].starter_};
+	const uint64_t own {hands_[starter]};
+	const uint64_t lho {hands_[starter + 1]};
+	const uint64_t partner {hands_[starter + 2]};
+	const uint64_t rho {hands_[starter + 3]};
+
+	const bool is_nt {suit_t::NoTrump == trump_};
+	const uint64_t trumps {is_nt ? 0 : suit_mask(trump_)};
+
+	std::size_t res {0};
+	for (std::size_t i = 0; i < 4; ++i)
+	{
+		const suit_t s {i};
+		const uint64_t mask {suit_mask(s)};
+		std::size_t winners {cards_count(top_cards(own & mask, (lho | partner | rho) & mask))};
+
+		// Side suit winners are cashed before trumps and only while opponents having trumps follow suit
+		if ((!is_nt) && (s != trump_))
+		{
+			if (0 != (lho & trumps))
+			{
+				winners = std::min(winners, cards_count(lho & mask));
+			}
+			if (0 != (rho & trumps))
+			{
+				winners = std::min(winners, cards_count(rho & mask));
+			}
+		}
+
+		res += winners;
+	}
+
+	return res;
+}
+
+std::size_t table_t::sure_losers() const noexcept
+{
+	// In no trump any card may be discarded, but trump higher than all trumps of the starter
+	// side wins a trick whenever it is played.
+	if (suit_t::NoTrump == trump_)
+	{
+		return 0;
+	}
+
+	const side_t starter {tricks_[trick_index_].starter_};
+	const uint64_t trumps {suit_mask(trump_)};
+	const uint64_t own {(hands_[starter] | hands_[starter + 2]) & trumps};
+
+	return std::max(cards_count(top_cards(hands_[starter + 1] & trumps, own)),
+					cards_count(top_cards(hands_[starter + 3] & trumps, own)));
+}
+
+void table_t::get_key(table_key& key) const noexcept
+{
+	constexpr uint64_t lanes {0x0001000100010001};
+
+	const side_t starter {tricks_[trick_index_].starter_};
+	const uint64_t hands[4] {hands_[starter], hands_[starter + 1], hands_[starter + 2], hands_[starter + 3]};
+	const uint64_t all {hands[0] | hands[1] | hands[2] | hands[3]};
+
+	// Every suit as one word: 16-bit lane per hand (from the turn starter). Remaining cards are
+	// moved down over the holes left by played cards, starting from the highest hole, so lanes
+	// of all hands are shifted at once. The word is also the pattern suits are ordered by.
+	uint64_t patterns[4];
+	for (unsigned s = 0; s < 4; ++s)
+	{
+		uint64_t w {0};
+		for (std::size_t h = 0; h < 4; ++h)
+		{
+			w |= ((hands[h] >> (16 * s)) & 0x1FFF) << (16 * h);
+		}
+
+		const uint64_t cards {(all >> (16 * s)) & 0x1FFF};
+		if (0 != cards)
+		{
+			uint64_t holes {~cards & ((static_cast<uint64_t>(1) << bits::highest(cards)) - 1)};
+			while (0 != holes)
+			{
+				const unsigned hole {bits::highest(holes)};
+				holes &= ~(static_cast<uint64_t>(1) << hole);
+
+				const uint64_t below {((static_cast<uint64_t>(1) << hole) - 1) * lanes};
+				const uint64_t above {((0xFFFF << hole) & 0x7FFF) * lanes};
+				w = (w & below) | ((w >> 1) & above);
+			}
+		}
+
+		patterns[s] = w;
+	}
+
+	// Without trumps left the table is the same as in no trump
+	const bool has_trumps {(suit_t::NoTrump != trump_) && (0 != (all & suit_mask(trump_)))};
+
+	uint8_t suits[4] {0, 1, 2, 3};
+	std::size_t ordered {4};
+	if (has_trumps)
+	{
+		std::swap(suits[static_cast<uint8_t>(trump_)], suits[3]);
+		ordered = 3;
+	}
+	std::sort(suits, suits + ordered, [&patterns](uint8_t s1, uint8_t s2) {
+		return patterns[s1] > patterns[s2];
+	});
+
+	uint16_t cards[4];
+	for (std::size_t c = 0; c < 4; ++c)
+	{
+		cards[c] = static_cast<uint16_t>((all >> (16 * suits[c])) & 0x1FFF);
+	}
+
+	for (std::size_t h = 0; h < 4; ++h)
+	{
+		uint64_t hand {0};
+		for (std::size_t c = 0; c < 4; ++c)
+		{
+			hand |= ((patterns[suits[c]] >> (16 * h)) & 0x1FFF) << (16 * c);
+		}
+		std::memcpy(&key.hash()[8 * h], &hand, sizeof(uint64_t));
+	}
+
+	key.set_trump(has_trumps ? suit_t {suit_t::Spades} : suit_t {suit_t::NoTrump});
+	key.set_mapping(suits, cards);
+}
+
+void table_t::dump(std::ostream& os) const
+{
+	for (const auto& side : side_t::all())
+	{
+		os << "  " << side << ":" << std::endl;
+		for (std::size_t i = 0; i < 4; ++i)
+		{
+			const card_t cards {static_cast<card_t::underlying_type>((hands_[side] >> (16 * i)) & 0x1FFF)};
+			os << std::setw(12) << suit_t {i} << " : " << first::cards_t {cards} << std::endl;
+		}
+	}
+
+	const auto& trick {tricks_[trick_index_]};
+
+	os << "  Trump           : " << trump_ << std::endl;
+	os << "  Turn starter    : " << trick.starter_ << std::endl;
+
+	os << "  Made moves      : ";
+	for (std::size_t i = 0; i < trick_size_; ++i)
+	{
+		os << trick.moves_[i] << " ";
+	}
+	os << std::endl;
+
+	if (!is_valid())
+	{
+		os << "  TABLE IS INVALID!" << std::endl;
+	}
+	else
+	{
+		os << "  Next player     : " << current_player() << std::endl;
+
+		os << "  Available moves : ";
+		moves_type am;
+		get_available_moves(am);
+		for (const auto& m : am)
+		{
+			os << m << " ";
+		}
+		os << std::endl;
+	}
+}
+
+bool table_t::is_valid() const noexcept
+{
+	if (0 != ((hands_[0] | hands_[1] | hands_[2] | hands_[3]) & ~(suit_mask(0) | suit_mask(1) | suit_mask(2) | suit_mask(3))))
+	{
+		return false;
+	}
+
+	// "Вернём" сыгравшие карты текущей взятки и проверим, а можно ли было ими играть
+	uint64_t hands[4] {hands_[0], hands_[1], hands_[2], hands_[3]};
+	const auto& trick {tricks_[trick_index_]};
+	side_t s {trick.starter_};
+	for (std::size_t i = 0; i < trick_size_; ++i, ++s)
+	{
+		const auto& m {trick.moves_[i]};
+		const uint64_t bit {card_bit(m)};
+		if ((0 != ((hands[0] | hands[1] | hands[2] | hands[3]) & bit))
+			|| ((m.suit() != trick.moves_[0].suit()) && (0 != (hands[s] & suit_mask(trick.moves_[0].suit())))))
+		{
+			return false;
+		}
+		hands[s] |= bit;
+	}
+
+	const std::size_t sz {cards_count(hands[0])};
+	if ((13 < sz) || (cards_count(hands[1]) != sz) || (cards_count(hands[2]) != sz) || (cards_count(hands[3]) != sz))
+	{
+		return false;
+	}
+
+	for (std::size_t i = 0; i < 3; ++i)
+	{
+		for (std::size_t j = i + 1; j < 4; ++j)
+		{
+			if (0 != (hands[i] & hands[j]))
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void table_t::get_available_moves(moves_type& moves) const
+{
+	moves.clear();
+
+	uint64_t cards {hands_[current_player()]};
+	if (0 != trick_size_)
+	{
+		const uint64_t in_suit {cards & suit_mask(tricks_[trick_index_].moves_[0].suit())};
+		if (0 != in_suit)
+		{
+			cards = in_suit;
+		}
+	}
+
+	bits::for_each(cards, [&moves](unsigned index) {
+		moves.push_back(move_t::from_index(index));
+	});
+}
+
+side_t table_t::make_move(const move_t& m)
+{
+	auto& trick {tricks_[trick_index_]};
+	const side_t side {trick.starter_ + trick_size_};
+	const uint64_t bit {card_bit(m)};
+
+	if ((0 == (hands_[side] & bit))
+		|| ((0 != trick_size_) && (m.suit() != trick.moves_[0].suit())
+			&& (0 != (hands_[side] & suit_mask(trick.moves_[0].suit())))))
+	{
+		throw std::logic_error {"Trying to make invalid move."};
+	}
+
+	hands_[side] &= ~bit;
+	trick.moves_[trick_size_++] = m;
+
+	if (4 == trick_size_)
+	{
+		std::size_t winer {0};
+		for (std::size_t i = 1; i < 4; ++i)
+		{
+			if (trick.moves_[i].is_beat(trick.moves_[winer], trump_))
+			{
+				winer = i;
+			}
+		}
+
+		tricks_[++trick_index_].starter_ = trick.starter_ + winer;
+		trick_size_ = 0;
+		--tricks_left_;
+	}
+
+	return tricks_[trick_index_].starter_;
+}
+
+void table_t::undo_move() noexcept
+{
+	if (0 == trick_size_)
+	{
+		--trick_index_;
+		trick_size_ = 4;
+		++tricks_left_;
+	}
+
+	const auto& trick {tricks_[trick_index_]};
+	--trick_size_;
+	hands_[trick.starter_ + trick_size_] |= card_bit(trick.moves_[trick_size_]);
+}
+
+} // namespace second
@@ -0,0 +1,212 @@
+#ifndef TABLE_SECOND_HPP
+#define TABLE_SECOND_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#include <iostream>
+
+#include <yaml-cpp/yaml.h>
+
+#include "enums.hpp"
+#include "moves.hpp"
+#include "table_first.h"
+#include "table_hash.hpp"
+#include "table_key.hpp"
+
+namespace second
+{
+
+/**
+ *****************************************************************************
+ * @brief The table_t class - compact table: every hand is a 64-bit mask
+ * (16 bits per suit, as in table_t::simplify() of the first table) and the
+ * played cards are kept as trick records, so moves are made and undone in
+ * place instead of copying the table.
+ */
+class table_t
+{
+public:
+	using hash_type = table_hash;
+	using move_type = move_t;
+	using moves_type = moves_t;
+
+public:
+	inline table_t() noexcept
+		: hands_ {0, 0, 0, 0}
+		, trump_ {suit_t::NoTrump}
+		, trick_index_ {0}
+		, trick_size_ {0}
+		, tricks_left_ {0}
+	{
+		tricks_[0].starter_ = side_t::North;
+	}
+
+	~table_t() = default;
+
+	table_t(const table_t&) = default;
+	table_t(table_t&&) = default;
+	table_t& operator=(const table_t&) = default;
+	table_t& operator=(table_t&&) = default;
+
+	explicit table_t(const first::table_t& t);
+
+	inline explicit table_t(const YAML::Node& n)
+		: table_t {first::table_t {n}}
+	{
+	}
+
+public:
+	void dump(std::ostream& os = std::cout) const;
+	bool is_valid() const noexcept;
+	void get_available_moves(moves_type& moves) const;
+
+	// Returns winner side, if turn is finished,.and turn starter otherwise.
+	side_t make_move(const move_t& m);
+
+	// Takes back the last move made by make_move().
+	void undo_move() noexcept;
+
+	inline side_t current_player() const noexcept
+	{
+		return tricks_[trick_index_].starter_ + trick_size_;
+	}
+
+	inline bool is_last_move() const noexcept
+	{
+		return (3 == trick_size_);
+	}
+
+	inline bool is_first_move() const noexcept
+	{
+		return (0 == trick_size_);
+	}
+
+	// Cards in hand of the current player (tricks left including the current one)
+	inline std::size_t max_tricks() const noexcept
+	{
+		return tricks_left_;
+	}
+
+	// Moves of the current player are equivalent, if there are no cards of other hands or of the
+	// current trick between them (cards played in previous tricks and own cards do not count).
+	inline bool is_equivalent(const move_t& m1, const move_t& m2) const noexcept
+	{
+		if (m1.suit() != m2.suit())
+		{
+			return false;
+		}
+
+		const auto& trick {tricks_[trick_index_]};
+		const side_t player {trick.starter_ + trick_size_};
+
+		uint64_t others {0};
+		for (std::size_t i = 0; i < trick_size_; ++i)
+		{
+			others |= card_bit(trick.moves_[i]);
+		}
+		others |= hands_[player + 1] | hands_[player + 2] | hands_[player + 3];
+
+		const uint64_t b1 {card_bit(m1)};
+		const uint64_t b2 {card_bit(m2)};
+		const uint64_t between {(b1 < b2) ? (b2 - (b1 << 1)) : (b1 - (b2 << 1))};
+		return (0 == (others & between));
+	}
+
+	// Static estimations for the side of turn starter, valid at the first move of a trick only:
+	// tricks it takes by cashing top cards of the starter hand, and tricks opponents take
+	// with top trumps anyway.
+	std::size_t quick_tricks() const noexcept;
+	std::size_t sure_losers() const noexcept;
+
+	inline const suit_t& trump() const noexcept
+	{
+		return trump_;
+	}
+
+	inline void set_starter(const side_t& s) noexcept
+	{
+		tricks_[trick_index_].starter_ = s;
+	}
+
+	inline void set_trump(const suit_t& t) noexcept
+	{
+		trump_ = t;
+	}
+
+	inline bool empty() const noexcept
+	{
+		return (0 == (hands_[0] | hands_[1] | hands_[2] | hands_[3]));
+	}
+
+	inline uint64_t hand(const side_t& s) const noexcept
+	{
+		return hands_[s];
+	}
+
+	inline std::size_t trick_size() const noexcept
+	{
+		return trick_size_;
+	}
+
+	inline const move_t& trick_move(std::size_t i) const noexcept
+	{
+		return tricks_[trick_index_].moves_[i];
+	}
+
+	// Cards of the side in the suit as card_t bits
+	inline uint16_t suit_cards(const side_t& side, suit_t s) const noexcept
+	{
+		return static_cast<uint16_t>((hands_[side] >> (16 * static_cast<unsigned>(s))) & 0x1FFF);
+	}
+
+	inline void get_hash(hash_type& res) const noexcept
+	{
+		auto ts {tricks_[trick_index_].starter_};
+		std::memcpy(&res[8 * 0], &hands_[ts++], sizeof(uint64_t));
+		std::memcpy(&res[8 * 1], &hands_[ts++], sizeof(uint64_t));
+		std::memcpy(&res[8 * 2], &hands_[ts++], sizeof(uint64_t));
+		std::memcpy(&res[8 * 3], &hands_[ts++], sizeof(uint64_t));
+	}
+
+	// Canonical form for cache: ranks of remaining cards are relative, suits are ordered by
+	// cards distribution (trump is always the last suit; trump contract without trumps left
+	// is stored as no trump), so equivalent tables share entries.
+	void get_key(table_key& key) const noexcept;
+
+	static inline uint64_t card_bit(const move_t& m) noexcept
+	{
+		return static_cast<uint64_t>(1) << m.index();
+	}
+
+	static inline uint64_t suit_mask(suit_t s) noexcept
+	{
+		return static_cast<uint64_t>(0x1FFF) << (16 * static_cast<unsigned>(s));
+	}
+
+private:
+	struct trick_record
+	{
+		side_t starter_;
+		move_t moves_[4];
+	};
+
+	static std::size_t cards_count(uint64_t cards) noexcept;
+
+	// Cards higher than all others of the same suit (both masks must be of one suit).
+	static uint64_t top_cards(uint64_t cards, uint64_t others) noexcept;
+
+private:
+	uint64_t hands_[4];
+	suit_t trump_;
+
+	// Current trick is tricks_[trick_index_], previous ones are kept for undo_move()
+	uint8_t trick_index_;
+	uint8_t trick_size_;
+	uint8_t tricks_left_;
+	trick_record tricks_[14];
+};
+
+} // namespace second
+
+#endif // TABLE_SECOND_HPP
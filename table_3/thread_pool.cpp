@@ -0,0 +1,178 @@
+#include "thread_pool.hpp"
+
+#include <utility>
+
+namespace
+{
+
+// Pool and queue of the worker running on the current thread
+thread_local const void* current_pool {nullptr};
+thread_local std::size_t current_queue {0};
+
+} // namespace
+
+thread_pool::thread_pool(std::size_t threads)
+{
+	if (0 == threads)
+	{
+		threads = 1;
+	}
+
+	queues_.reserve(threads);
+	for (std::size_t i = 0; i < threads; ++i)
+	{
+		queues_.push_back(std::make_unique<queue_type>());
+	}
+
+	threads_.reserve(threads);
+	for (std::size_t i = 0; i < threads; ++i)
+	{
+		threads_.emplace_back(&thread_pool::worker, this, i);
+	}
+}
+
+thread_pool::~thread_pool()
+{
+	{
+		std::lock_guard<std::mutex> lock {mutex_};
+		stop_ = true;
+	}
+	cv_task_.notify_all();
+
+	for (auto& t : threads_)
+	{
+		t.join();
+	}
+}
+
+void thread_pool::submit(group& g, std::function<void()> task)
+{
+	g.pending_.fetch_add(1, std::memory_order_relaxed);
+
+	auto& q {*queues_[queue_index(true)]};
+	{
+		std::lock_guard<std::mutex> lock {q.mutex_};
+		q.tasks_.push_back(task_type {&g, std::move(task)});
+	}
+	queued_.fetch_add(1);
+
+	// Sleepers check queued_ under mutex_, so the notification can not be lost
+	std::lock_guard<std::mutex> lock {mutex_};
+	cv_task_.notify_one();
+	if (0 != waiting_)
+	{
+		cv_done_.notify_all();
+	}
+}
+
+void thread_pool::wait(group& g)
+{
+	const std::size_t index {queue_index(false)};
+	task_type task {};
+	while (0 != g.pending_.load())
+	{
+		if (try_pop(index, task))
+		{
+			execute(task);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock {mutex_};
+		++waiting_;
+		cv_done_.wait(lock, [this, &g]() { return (0 == g.pending_.load()) || (0 != queued_.load()); });
+		--waiting_;
+	}
+
+	std::lock_guard<std::mutex> lock {mutex_};
+	if (g.error_)
+	{
+		std::rethrow_exception(std::exchange(g.error_, nullptr));
+	}
+}
+
+void thread_pool::worker(std::size_t index)
+{
+	current_pool = this;
+	current_queue = index;
+
+	task_type task {};
+	while (true)
+	{
+		if (try_pop(index, task))
+		{
+			execute(task);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock {mutex_};
+		cv_task_.wait(lock, [this]() { return stop_ || (0 != queued_.load()); });
+		if (stop_ && (0 == queued_.load()))
+		{
+			return;
+		}
+	}
+}
+
+bool thread_pool::try_pop(std::size_t index, task_type& task)
+{
+	if (0 == queued_.load())
+	{
+		return false;
+	}
+
+	// Own queue first (the newest task), then the oldest tasks of other queues
+	for (std::size_t i = 0; i < queues_.size(); ++i)
+	{
+		auto& q {*queues_[(index + i) % queues_.size()]};
+		std::lock_guard<std::mutex> lock {q.mutex_};
+		if (!q.tasks_.empty())
+		{
+			if (0 == i)
+			{
+				task = std::move(q.tasks_.back());
+				q.tasks_.pop_back();
+			}
+			else
+			{
+				task = std::move(q.tasks_.front());
+				q.tasks_.pop_front();
+			}
+			queued_.fetch_sub(1);
+			return true;
+		}
+	}
+	return false;
+}
+
+void thread_pool::execute(task_type& task)
+{
+	std::exception_ptr error {};
+	try
+	{
+		task.func_();
+	}
+	catch (...)
+	{
+		error = std::current_exception();
+	}
+	task.func_ = nullptr;
+
+	std::lock_guard<std::mutex> lock {mutex_};
+	if (error && !task.group_->error_)
+	{
+		task.group_->error_ = error;
+	}
+	if (1 == task.group_->pending_.fetch_sub(1))
+	{
+		cv_done_.notify_all();
+	}
+}
+
+std::size_t thread_pool::queue_index(bool for_submit) noexcept
+{
+	if (this == current_pool)
+	{
+		return current_queue;
+	}
+	return for_submit ? (next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size()) : 0;
+}
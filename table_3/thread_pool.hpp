@@ -0,0 +1,100 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <cstddef>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ *****************************************************************************
+ * @brief The thread_pool class - fixed set of worker threads executing
+ * submitted tasks. Tasks are tracked by groups; waiting for a group executes
+ * queued tasks on the calling thread, so tasks may wait for nested groups.
+ * Every worker has its own queue: tasks submitted by a worker go to its
+ * queue and are taken from its back (the newest first), idle workers steal
+ * the oldest tasks from the fronts of other queues.
+ */
+class thread_pool
+{
+public:
+	class group
+	{
+	public:
+		group() = default;
+		~group() = default;
+
+		group(const group&) = delete;
+		group(group&&) = delete;
+		group& operator=(const group&) = delete;
+		group& operator=(group&&) = delete;
+
+	private:
+		std::atomic<std::size_t> pending_ {0};
+		std::exception_ptr error_ {};
+
+		friend class thread_pool;
+	};
+
+public:
+	explicit thread_pool(std::size_t threads = std::thread::hardware_concurrency());
+	~thread_pool();
+
+	thread_pool(const thread_pool&) = delete;
+	thread_pool(thread_pool&&) = delete;
+	thread_pool& operator=(const thread_pool&) = delete;
+	thread_pool& operator=(thread_pool&&) = delete;
+
+public:
+	inline std::size_t size() const noexcept
+	{
+		return threads_.size();
+	}
+
+	void submit(group& g, std::function<void()> task);
+
+	// Returns when all tasks of the group are finished; rethrows first exception thrown by them.
+	void wait(group& g);
+
+private:
+	struct task_type
+	{
+		group* group_;
+		std::function<void()> func_;
+	};
+
+	struct alignas(64) queue_type
+	{
+		std::mutex mutex_;
+		std::deque<task_type> tasks_;
+	};
+
+	void worker(std::size_t index);
+	bool try_pop(std::size_t index, task_type& task);
+	void execute(task_type& task);
+
+	// Queue of the calling thread: own queue for workers, round robin for other threads
+	std::size_t queue_index(bool for_submit) noexcept;
+
+private:
+	std::vector<std::unique_ptr<queue_type>> queues_;
+	std::atomic<std::size_t> queued_ {0};
+	std::atomic<std::size_t> next_queue_ {0};
+
+	// Guards sleeping: workers wait for tasks, other threads wait for their groups
+	std::mutex mutex_;
+	std::condition_variable cv_task_;
+	std::condition_variable cv_done_;
+	std::size_t waiting_ {0};
+	bool stop_ {false};
+	std::vector<std::thread> threads_;
+};
+
+#endif // THREAD_POOL_HPP